@@ -0,0 +1,147 @@
+// Recall@k and queries/sec of HnswIndex against exact brute-force search
+// (SimilarityIndex) on the chatbot.db word vectors and on larger synthetic
+// tables, plus a save/load round trip and loads of damaged files.
+//
+// Usage: ann_bench [path/to/chatbot.db] [synthetic rows]
+#include "../include/Core/EmbeddingStore.hpp"
+#include "../include/Core/HnswIndex.hpp"
+#include "../include/Core/SimilarityIndex.hpp"
+#include <sqlite3.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+    const size_t kK = 10;
+
+    double seconds(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Writes bytes to path and loads them; a file that loads must also be safe to search
+    bool loads(const std::string& path, const std::string& bytes, int dim, const std::vector<float>& query) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(bytes.data(), bytes.size());
+        HnswIndex index(dim);
+        if (!index.load(path)) return false;
+        index.search(query, kK);
+        return true;
+    }
+
+    std::string withField(std::string bytes, size_t offset, uint32_t value) {
+        std::memcpy(&bytes[offset], &value, sizeof(value));
+        return bytes;
+    }
+
+    void evaluate(const std::string& label, const std::vector<std::string>& keys,
+                  const std::vector<std::vector<float>>& data, int dim, size_t queryCount, std::mt19937& rng) {
+        SimilarityIndex exact(dim);
+        for (uint32_t i = 0; i < data.size(); ++i) exact.set(i, data[i].data());
+
+        auto start = std::chrono::steady_clock::now();
+        HnswIndex ann(dim);
+        for (size_t i = 0; i < data.size(); ++i) ann.insert(keys[i], data[i].data());
+        double buildSec = seconds(start);
+
+        // Queries are stored vectors plus noise, so they come from the same distribution as the data
+        std::normal_distribution<float> noise(0.0f, 0.05f);
+        std::uniform_int_distribution<size_t> pick(0, data.size() - 1);
+        std::vector<std::vector<float>> queries;
+        for (size_t i = 0; i < queryCount; ++i) {
+            queries.push_back(data[pick(rng)]);
+            for (auto& x : queries.back()) x += noise(rng);
+        }
+
+        // Ground truth; neighbours tied on score with the k-th result also count as hits
+        start = std::chrono::steady_clock::now();
+        std::vector<std::vector<std::pair<uint32_t, float>>> truth;
+        for (const auto& q : queries) truth.push_back(exact.topK(q, kK));
+        double exactQps = queries.size() / seconds(start);
+
+        std::cout << label << ": " << data.size() << " x " << dim << ", build " << buildSec << " s, exact "
+                  << static_cast<long>(exactQps) << " qps\n";
+
+        for (size_t ef : {16, 32, 64, 128, 256}) {
+            start = std::chrono::steady_clock::now();
+            std::vector<std::vector<std::pair<std::string, float>>> results;
+            for (const auto& q : queries) results.push_back(ann.search(q, kK, ef));
+            double qps = queries.size() / seconds(start);
+
+            size_t hits = 0, total = 0;
+            for (size_t i = 0; i < queries.size(); ++i) {
+                float cutoff = truth[i].back().second - 1e-6f;
+                for (const auto& [key, score] : results[i]) hits += score >= cutoff;
+                total += truth[i].size();
+            }
+            std::cout << "  ef=" << ef << ": recall@" << kK << " " << static_cast<double>(hits) / total
+                      << ", " << static_cast<long>(qps) << " qps\n";
+        }
+
+        std::string path = "ann_bench_roundtrip.hnsw";
+        HnswIndex reloaded(dim);
+        bool roundTrip = ann.save(path) && reloaded.load(path) && reloaded.size() == ann.size() &&
+                         reloaded.search(queries[0], kK) == ann.search(queries[0], kK);
+        std::cout << "  save/load round trip: " << (roundTrip ? "ok" : "FAILED") << "\n";
+
+        // Header: magic, version, dimension, M, count (offset 16), top layer (20), entry point (24)
+        std::ifstream saved(path, std::ios::binary);
+        std::string bytes((std::istreambuf_iterator<char>(saved)), std::istreambuf_iterator<char>());
+        saved.close();
+        std::streambuf* log = std::cerr.rdbuf(nullptr);  // One "Ignoring corrupt index file" per rejection
+        bool rejected = !loads(path, withField(bytes, 16, 0xFFFFFFFFu), dim, queries[0]) &&
+                        !loads(path, withField(bytes, 20, 1000), dim, queries[0]) &&
+                        !loads(path, withField(bytes, 20, 0xFFFFFFFFu), dim, queries[0]) &&
+                        !loads(path, bytes.substr(0, bytes.size() / 2), dim, queries[0]);
+        std::uniform_int_distribution<size_t> position(0, bytes.size() - 1);
+        size_t loadedDamaged = 0;
+        for (int i = 0; i < 200; ++i) {  // Single flipped bytes: rejected, or loaded and searched without crashing
+            std::string damaged = bytes;
+            damaged[position(rng)] ^= static_cast<char>(1 + i % 255);
+            loadedDamaged += loads(path, damaged, dim, queries[0]);
+        }
+        std::cerr.rdbuf(log);
+        std::remove(path.c_str());
+        std::cout << "  damaged files: " << (rejected ? "rejected" : "NOT REJECTED") << ", " << loadedDamaged
+                  << " of 200 with one flipped byte still loaded\n";
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string dbPath = argc > 1 ? argv[1] : "chatbot.db";
+    size_t syntheticRows = argc > 2 ? std::stoul(argv[2]) : 20000;
+    std::mt19937 rng(7);
+
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK) {
+        EmbeddingStore store(3);
+        store.load(db);
+        std::vector<std::string> keys;
+        std::vector<std::vector<float>> data;
+        for (uint32_t id = 0; id < store.size(); ++id) {
+            keys.emplace_back(store.word(id));
+            data.emplace_back(store.vector(id), store.vector(id) + 3);
+        }
+        if (!data.empty()) evaluate("chatbot.db words", keys, data, 3, 500, rng);
+    } else {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+    }
+    sqlite3_close(db);
+
+    for (int dim : {3, 100}) {
+        std::normal_distribution<float> dist(0.0f, 1.0f);
+        std::vector<std::string> keys;
+        std::vector<std::vector<float>> data(syntheticRows, std::vector<float>(dim));
+        for (size_t i = 0; i < syntheticRows; ++i) {
+            keys.push_back(std::to_string(i));
+            for (auto& x : data[i]) x = dist(rng);
+        }
+        evaluate("synthetic", keys, data, dim, 500, rng);
+    }
+    return 0;
+}
@@ -0,0 +1,197 @@
+// Heap held by one ContextTracker as a conversation grows, against the
+// previous tracker (a deque of messages plus an id -> score map that kept
+// every keyword ever boosted). Each turn adds a message drawn from the text
+// column of intents.csv, plus a few never-repeated words, and boosts its
+// keywords. The previous tracker's count includes the words it interned into
+// the shared vocabulary, which are never freed; the ring must intern none.
+// Also times a turn and a summary, and checks the lazily decayed scores
+// against scores decayed every turn while no topic is evicted.
+//
+// Usage: context_bench [path/to/intents.csv] [turns]
+#include "../include/Humanizer/ContextTracker.hpp"
+#include "../include/Core/CsvReader.hpp"
+#include "../include/Core/Tokenizer.hpp"
+#include "../include/Core/Vocabulary.hpp"
+#include <malloc.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    std::atomic<long long> liveBytes{0};  // Usable size of every live allocation
+
+    void* allocate(size_t size) {
+        if (void* p = std::malloc(size ? size : 1)) {
+            liveBytes.fetch_add(static_cast<long long>(malloc_usable_size(p)), std::memory_order_relaxed);
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+
+    void release(void* p) noexcept {
+        if (p) liveBytes.fetch_sub(static_cast<long long>(malloc_usable_size(p)), std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+// Every form the program can call goes through the same pair, so the
+// counted and the freed bytes always match
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // ContextTracker as it was
+    struct PreviousTracker {
+        std::deque<std::string> contextDeque;
+        std::unordered_map<Vocabulary::Id, int> topicRelevance;
+
+        void addMessage(const std::string& message) {
+            contextDeque.push_back(message);
+            if (contextDeque.size() > ContextTracker::MAX_CONTEXT_SIZE) contextDeque.pop_front();
+        }
+        void boostTopicRelevanceByKeywords(const std::string& message) {
+            std::vector<Vocabulary::Id> boosted;
+            for (const auto& token : Tokenizer::local().tokenize(message)) {
+                if (token.text.size() <= 3) continue;
+                Vocabulary::Id id = Vocabulary::global().intern(token.text);
+                if (std::find(boosted.begin(), boosted.end(), id) != boosted.end()) continue;
+                boosted.push_back(id);
+                topicRelevance[id] += 1;
+            }
+        }
+        std::string summarizeContext() const {
+            std::vector<std::pair<std::string_view, int>> topics;
+            for (const auto& [id, score] : topicRelevance) {
+                if (score > 1) topics.emplace_back(Vocabulary::global().word(id), score);
+            }
+            std::sort(topics.begin(), topics.end());
+            std::ostringstream oss;
+            for (const auto& [topic, score] : topics) oss << topic << "(" << score << ") ";
+            return oss.str();
+        }
+    };
+
+    std::vector<std::string> loadMessages(const std::string& csvPath) {
+        std::vector<std::string> messages;
+        std::ifstream file(csvPath, std::ios::binary);
+        CsvReader reader(file);
+        std::vector<std::string> fields;
+        bool header = true;
+        while (reader.next(fields)) {
+            if (header) { header = false; continue; }
+            if (fields.size() > 1 && !fields[1].empty()) messages.push_back(fields[1]);
+        }
+        return messages;
+    }
+
+    // Turn i's message: a phrase from the dataset and a word no earlier turn used
+    std::vector<std::string> makeTurns(const std::vector<std::string>& messages, size_t turns) {
+        std::vector<std::string> result;
+        result.reserve(turns);
+        for (size_t i = 0; i < turns; ++i) {
+            result.push_back(messages[(i * 7919) % messages.size()] + " word" + std::to_string(i));
+        }
+        return result;
+    }
+
+    template <typename Tracker>
+    void measure(const char* name, const std::vector<std::string>& turns) {
+        long long before = liveBytes.load();
+        auto* tracker = new Tracker();
+        size_t summaryBytes = 0;
+        double turnNs = 0.0, summaryNs = 0.0;
+        std::printf("%-9s", name);
+        for (size_t i = 0, checkpoint = 1000; i < turns.size(); ++i) {
+            auto start = Clock::now();
+            tracker->addMessage(turns[i]);
+            tracker->boostTopicRelevanceByKeywords(turns[i]);
+            auto turned = Clock::now();
+            turnNs += std::chrono::duration<double, std::nano>(turned - start).count();
+            if (i % 100 == 99) {
+                summaryBytes += tracker->summarizeContext().size();
+                summaryNs += std::chrono::duration<double, std::nano>(Clock::now() - turned).count();
+            }
+            if (i + 1 == checkpoint) {
+                std::printf("  %8lld", liveBytes.load() - before);
+                checkpoint *= 10;
+            }
+        }
+        std::printf("  | %6.0f ns/turn, %9.0f ns/summary (%zu bytes of summaries)\n",
+                    turnNs / turns.size(), summaryNs / (turns.size() / 100), summaryBytes);
+        delete tracker;
+    }
+
+    // With at most MAX_TOPICS distinct keywords nothing is evicted, so every score
+    // must match a table that decays each entry on every turn
+    size_t checkDecay(const std::vector<std::string>& messages) {
+        ContextTracker tracker;
+        std::map<std::string, double> exact;
+        const double perTurn = std::pow(0.5, 1.0 / ContextTracker::TOPIC_HALF_LIFE);
+        size_t mismatches = 0;
+        std::vector<std::string> words;
+        for (size_t i = 0; words.size() < ContextTracker::MAX_TOPICS / 2; ++i) words.push_back("topic" + std::to_string(i));
+
+        for (size_t turn = 0; turn < 100000; ++turn) {
+            tracker.addMessage(messages[turn % messages.size()]);
+            for (auto& [word, score] : exact) score *= perTurn;
+            const std::string& word = words[(turn * turn) % words.size()];
+            int amount = 1 + static_cast<int>(turn % 3);
+            tracker.boostTopicRelevance(word, amount);
+            exact[word] += amount;
+
+            if (turn % 997 == 0) {
+                auto top = tracker.topTopics(ContextTracker::MAX_TOPICS);
+                for (size_t i = 0; i < top.size(); ++i) {
+                    double expected = exact[std::string(top[i].first)];
+                    if (std::fabs(top[i].second - expected) > 1e-4 * std::max(1.0, expected)) mismatches++;
+                    if (i > 0 && top[i].second > top[i - 1].second) mismatches++;
+                }
+                if (top.size() != exact.size()) mismatches++;
+            }
+        }
+        return mismatches;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string csvPath = argc > 1 ? argv[1] : "datasets/intents.csv";
+    size_t turns = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+
+    std::vector<std::string> messages = loadMessages(csvPath);
+    if (messages.empty()) {
+        std::cerr << "No messages in " << csvPath << "\n";
+        return 1;
+    }
+    std::vector<std::string> conversation = makeTurns(messages, turns);
+
+    // The ring runs first, so the words are still new to the vocabulary
+    std::printf("heap held after 10^3, 10^4, ... turns\n");
+    size_t words = Vocabulary::global().size();
+    measure<ContextTracker>("ring", conversation);
+    size_t ringInterned = Vocabulary::global().size() - words;
+    measure<PreviousTracker>("previous", conversation);
+    size_t previousInterned = Vocabulary::global().size() - words - ringInterned;
+    std::printf("words interned into the shared vocabulary: ring %zu, previous %zu\n", ringInterned, previousInterned);
+
+    size_t mismatches = checkDecay(messages);
+    std::printf("%s\n", mismatches == 0 ? "lazily decayed scores match per-turn decay" : "DECAYED SCORES DIFFER");
+    return mismatches == 0 && ringInterned == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+// Benchmarks the edit-distance kernels over topic pairs from intents.csv and
+// checks they agree with the original matrix implementation.
+//
+// Usage: edit_distance_bench [path/to/intents.csv] [pairs]
+#include "../include/Core/EditDistance.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    int matrixLevenshtein(const std::string& a, const std::string& b) {
+        std::vector<std::vector<int>> dist(a.size() + 1, std::vector<int>(b.size() + 1));
+        for (size_t i = 0; i <= a.size(); ++i) {
+            for (size_t j = 0; j <= b.size(); ++j) {
+                if (i == 0) dist[i][j] = static_cast<int>(j);
+                else if (j == 0) dist[i][j] = static_cast<int>(i);
+                else dist[i][j] = std::min({dist[i - 1][j] + 1, dist[i][j - 1] + 1,
+                                            dist[i - 1][j - 1] + (a[i - 1] != b[j - 1])});
+            }
+        }
+        return dist[a.size()][b.size()];
+    }
+
+    // Second field of a CSV line, honouring double-quoted fields
+    std::string secondField(const std::string& line) {
+        std::string field;
+        int column = 0;
+        bool quoted = false;
+        for (size_t i = 0; i < line.size(); ++i) {
+            char c = line[i];
+            if (quoted) {
+                if (c == '"' && i + 1 < line.size() && line[i + 1] == '"') { field += '"'; ++i; }
+                else if (c == '"') quoted = false;
+                else if (column == 1) field += c;
+            } else if (c == '"') {
+                quoted = true;
+            } else if (c == ',') {
+                if (++column > 1) break;
+            } else if (column == 1) {
+                field += c;
+            }
+        }
+        return field;
+    }
+
+    template <typename Fn>
+    double timeKernel(const std::vector<std::pair<std::string, std::string>>& pairs, Fn fn, long long& checksum) {
+        auto start = std::chrono::steady_clock::now();
+        checksum = 0;
+        for (const auto& [a, b] : pairs) checksum += fn(a, b);
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / pairs.size();
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string csvPath = argc > 1 ? argv[1] : "datasets/intents.csv";
+    size_t pairCount = argc > 2 ? std::stoul(argv[2]) : 200000;
+
+    std::ifstream file(csvPath);
+    if (!file) {
+        std::cerr << "Can't open " << csvPath << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> topics;
+    std::string line;
+    std::getline(file, line);  // Header
+    while (std::getline(file, line)) {
+        std::string topic = secondField(line);
+        if (!topic.empty()) topics.push_back(topic);
+    }
+    if (topics.size() < 2) {
+        std::cerr << "Not enough topics in " << csvPath << std::endl;
+        return 1;
+    }
+
+    std::vector<std::pair<std::string, std::string>> pairs;
+    pairs.reserve(pairCount);
+    for (size_t i = 0; i < pairCount; ++i) {
+        pairs.emplace_back(topics[(i * 31) % topics.size()], topics[(i * 7919 + 1) % topics.size()]);
+    }
+
+    // Correctness against the reference before timing anything
+    size_t mismatches = 0;
+    for (size_t i = 0; i < std::min<size_t>(pairs.size(), 20000); ++i) {
+        const auto& [a, b] = pairs[i];
+        int reference = matrixLevenshtein(a, b);
+        if (EditDistance::levenshtein(a, b) != reference) ++mismatches;
+        if (EditDistance::twoRow(a, b) != reference) ++mismatches;
+        if (EditDistance::bounded(a, b, 2) != std::min(reference, 3)) ++mismatches;
+    }
+
+    long long sumMatrix, sumRow, sumMyers, sumBounded;
+    double matrixNs = timeKernel(pairs, matrixLevenshtein, sumMatrix);
+    double rowNs = timeKernel(pairs, EditDistance::twoRow, sumRow);
+    double myersNs = timeKernel(pairs, EditDistance::levenshtein, sumMyers);
+    double boundedNs = timeKernel(pairs, [](const std::string& a, const std::string& b) {
+        return EditDistance::bounded(a, b, 2);
+    }, sumBounded);
+
+    std::cout << "topics:          " << topics.size() << "\n"
+              << "pairs:           " << pairs.size() << "\n"
+              << "mismatches:      " << mismatches << "\n"
+              << "matrix (old):    " << matrixNs << " ns/pair\n"
+              << "two-row:         " << rowNs << " ns/pair\n"
+              << "bit-parallel:    " << myersNs << " ns/pair\n"
+              << "banded (k=2):    " << boundedNs << " ns/pair" << std::endl;
+    return (mismatches == 0 && sumMatrix == sumMyers && sumMatrix == sumRow) ? 0 : 1;
+}
@@ -0,0 +1,184 @@
+// Builds a scratch word_vectors table for each specialized dimension and
+// checks that NeuralNet picks that dimension up, that vectorize into an
+// Embedding<N> matches a double-precision reference and allocates nothing,
+// and times it against the previous istringstream + std::vector version.
+//
+// Usage: embedding_bench [scratch db path] [iterations]
+#include "../include/Core/NeuralNet.hpp"
+#include "../include/Core/VectorCodec.hpp"
+#include "../include/Core/VectorMath.hpp"
+#include <sqlite3.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::atomic<bool> countAllocations{false};
+    std::atomic<size_t> allocations{0};
+}
+
+void* operator new(size_t size) {
+    if (countAllocations.load(std::memory_order_relaxed)) allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+    const int kWords = 2000;
+
+    std::string wordName(int i) { return "w" + std::to_string(i); }
+
+    void removeScratch(const std::string& path) {
+        for (const char* suffix : { "", "-wal", "-shm", ".words.hnsw" })
+            std::remove((path + suffix).c_str());
+    }
+
+    std::vector<std::vector<float>> writeScratch(const std::string& path, int dim, std::mt19937& rng) {
+        removeScratch(path);
+        std::normal_distribution<float> dist(0.0f, 1.0f);
+        std::vector<std::vector<float>> vectors(kWords, std::vector<float>(dim));
+
+        sqlite3* db;
+        sqlite3_open(path.c_str(), &db);
+        sqlite3_exec(db, "CREATE TABLE word_vectors (word TEXT PRIMARY KEY, vector BLOB); BEGIN;", nullptr, nullptr, nullptr);
+        sqlite3_stmt* stmt;
+        sqlite3_prepare_v2(db, "INSERT INTO word_vectors (word, vector) VALUES (?, ?);", -1, &stmt, nullptr);
+        for (int i = 0; i < kWords; ++i) {
+            for (float& x : vectors[i]) x = dist(rng);
+            std::string word = wordName(i);
+            sqlite3_bind_text(stmt, 1, word.c_str(), -1, SQLITE_TRANSIENT);
+            VectorCodec::bindVector(stmt, 2, vectors[i]);
+            sqlite3_step(stmt);
+            sqlite3_reset(stmt);
+        }
+        sqlite3_finalize(stmt);
+        sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+        sqlite3_close(db);
+        return vectors;
+    }
+
+    // Sentences of 4-12 known words plus the odd unknown one
+    std::vector<std::string> makeSentences(size_t count, std::mt19937& rng) {
+        std::uniform_int_distribution<int> word(0, kWords - 1), length(4, 12), unknown(0, 9);
+        std::vector<std::string> sentences;
+        for (size_t s = 0; s < count; ++s) {
+            std::string text;
+            for (int n = length(rng); n > 0; --n) {
+                text += unknown(rng) == 0 ? "unseen" : wordName(word(rng));
+                text += ' ';
+            }
+            sentences.push_back(text);
+        }
+        return sentences;
+    }
+
+    std::vector<double> reference(const std::string& text, const std::vector<std::vector<float>>& vectors, int dim) {
+        std::vector<double> sum(dim, 0.0);
+        std::istringstream stream(text);
+        std::string token;
+        while (stream >> token) {
+            if (token[0] != 'w') continue;
+            const auto& v = vectors[std::stoi(token.substr(1))];
+            for (int i = 0; i < dim; ++i) sum[i] += v[i];
+        }
+        double norm = 0.0;
+        for (double x : sum) norm += x * x;
+        norm = std::sqrt(norm);
+        if (norm > 0.0) for (double& x : sum) x /= norm;
+        return sum;
+    }
+
+    // vectorizeInto before Embedding<N>: istringstream tokens, std::string copies, a std::vector result
+    std::vector<float> previousVectorize(const std::string& input, const EmbeddingStore& store) {
+        int dim = store.dimension();
+        std::vector<float> embedding(dim, 0.0f);
+        std::istringstream tokenStream(input);
+        std::string token;
+        int wordCount = 0;
+        while (tokenStream >> token) {
+            if (const float* wordVector = store.find(token)) VectorMath::axpy(1.0f, wordVector, embedding.data(), dim);
+            wordCount++;
+        }
+        if (wordCount > 0) for (float& x : embedding) x /= wordCount;
+        float norm = VectorMath::norm(embedding.data(), dim);
+        if (norm > 0) for (float& x : embedding) x /= norm;
+        return embedding;
+    }
+
+    double elapsedNs(std::chrono::steady_clock::time_point start, size_t calls) {
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / calls;
+    }
+
+    template <int N>
+    bool run(const std::string& path, size_t iterations, std::mt19937& rng) {
+        auto vectors = writeScratch(path, N, rng);
+        auto sentences = makeSentences(256, rng);
+        bool ok = true;
+        {
+            DatabaseConfig config;
+            config.path = path;
+            NeuralNet net(std::make_shared<DatabasePool>(config));
+            if (net.dimension() != N) {
+                std::cerr << "dim " << N << ": NeuralNet detected " << net.dimension() << "\n";
+                return false;
+            }
+
+            Embedding<N> out;
+            double worst = 0.0;
+            for (const auto& text : sentences) {
+                net.vectorize(text, out);
+                auto want = reference(text, vectors, N);
+                for (int i = 0; i < N; ++i) worst = std::max(worst, std::fabs(out[i] - want[i]));
+            }
+            ok = worst < 1e-5;
+
+            allocations = 0;
+            countAllocations = true;
+            auto start = std::chrono::steady_clock::now();
+            volatile float sink = 0.0f;
+            for (size_t i = 0; i < iterations; ++i) {
+                net.vectorize(sentences[i % sentences.size()], out);
+                sink = sink + out[0];
+            }
+            double fixedNs = elapsedNs(start, iterations);
+            countAllocations = false;
+            size_t fixedAllocations = allocations;
+            ok = ok && fixedAllocations == 0;
+
+            EmbeddingStore store(N);
+            for (int i = 0; i < kWords; ++i) store.set(wordName(i), vectors[i]);
+            start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < iterations; ++i) sink = sink + previousVectorize(sentences[i % sentences.size()], store)[0];
+            double previousNs = elapsedNs(start, iterations);
+
+            std::cout << "dim " << N << ": max error " << worst << ", " << fixedAllocations << " allocations in "
+                      << iterations << " calls, Embedding<" << N << "> " << fixedNs << " ns vs previous "
+                      << previousNs << " ns per call\n";
+        }
+        removeScratch(path);
+        return ok;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "embedding_bench.db";
+    size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200000;
+    std::mt19937 rng(11);
+
+    bool ok = run<3>(path, iterations, rng);
+    ok = run<50>(path, iterations, rng) && ok;
+    ok = run<100>(path, iterations, rng) && ok;
+    ok = run<300>(path, iterations, rng) && ok;
+    std::cout << (ok ? "All checks passed" : "CHECKS FAILED") << "\n";
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,195 @@
+// Cost of a feedback click: the previous synchronous autocommit UPDATE (with
+// and without the (topic, response) index) against the write-behind queue in
+// ResponseVariator. Then checks that the flushed confidences equal the stored
+// ones plus every delta, and prints the queue counters. Finally gives feedback
+// through a re-cased, padded input for a topic stored under several spellings
+// and checks that memory and every matching row moved together.
+//
+// Runs on a temporary copy of the database, since feedback changes it.
+//
+// Usage: feedback_bench [path/to/chatbot.db] [clicks]
+#include "../include/Humanizer/ResponseVariator.hpp"
+#include <sqlite3.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+    using Key = std::pair<std::string, std::string>;
+
+    double usSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count();
+    }
+
+    struct Row {
+        Key key;
+        double confidence;
+    };
+
+    std::map<int64_t, Row> loadRows(Database& db, size_t limit) {
+        std::map<int64_t, Row> rows;
+        auto stmt = db.prepare("SELECT id, topic, response, confidence FROM responses "
+                               "WHERE topic IS NOT NULL AND response IS NOT NULL ORDER BY id LIMIT " + std::to_string(limit) + ";");
+        while (stmt && stmt.step() == SQLITE_ROW) {
+            rows[sqlite3_column_int64(stmt, 0)] = {{reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)),
+                                                    reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2))},
+                                                   sqlite3_column_double(stmt, 3)};
+        }
+        return rows;
+    }
+
+    // (spelling, confidence) of every row whose topic normalizes to `key` with this response, by id
+    std::vector<std::pair<std::string, double>> rowsFor(Database& db, const std::string& key, const std::string& response) {
+        std::vector<std::pair<std::string, double>> rows;
+        auto stmt = db.prepare("SELECT topic, confidence FROM responses WHERE response = ? ORDER BY id;");
+        sqlite3_bind_text(stmt, 1, response.c_str(), -1, SQLITE_TRANSIENT);
+        while (stmt && stmt.step() == SQLITE_ROW) {
+            const unsigned char* topic = sqlite3_column_text(stmt, 0);
+            if (topic && TopicIndex::normalize(reinterpret_cast<const char*>(topic)) == key) {
+                rows.emplace_back(reinterpret_cast<const char*>(topic), sqlite3_column_double(stmt, 1));
+            }
+        }
+        return rows;
+    }
+
+    // A (topic, response) stored under more than one spelling of the topic, if there is one
+    bool findRespelledPair(Database& db, std::string& key, std::string& response) {
+        std::map<Key, std::vector<std::string>> spellings;
+        auto stmt = db.prepare("SELECT topic, response FROM responses WHERE topic IS NOT NULL AND response IS NOT NULL;");
+        while (stmt && stmt.step() == SQLITE_ROW) {
+            std::string topic = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+            auto& seen = spellings[{TopicIndex::normalize(topic), reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1))}];
+            if (std::find(seen.begin(), seen.end(), topic) == seen.end()) seen.push_back(topic);
+        }
+        for (const auto& [pair, seen] : spellings) {
+            if (seen.size() > 1) {
+                key = pair.first;
+                response = pair.second;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The old updateConfidenceInDatabase: one autocommit UPDATE per click
+    double synchronousClicks(Database& db, const std::vector<Key>& keys, size_t clicks) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < clicks; ++i) {
+            auto stmt = db.prepare("UPDATE responses SET confidence = confidence + ? WHERE topic = ? AND response = ?;");
+            const Key& key = keys[(i / 2) % keys.size()];
+            sqlite3_bind_double(stmt, 1, i % 2 == 0 ? 0.1 : -0.1);  // Each pair of clicks cancels out
+            sqlite3_bind_text(stmt, 2, key.first.c_str(), -1, SQLITE_STATIC);
+            sqlite3_bind_text(stmt, 3, key.second.c_str(), -1, SQLITE_STATIC);
+            stmt.step();
+        }
+        return usSince(start) / clicks;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string source = argc > 1 ? argv[1] : "chatbot.db";
+    size_t clicks = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+
+    auto copy = std::filesystem::temp_directory_path() / "nova_feedback_bench.db";
+    std::error_code error;
+    std::filesystem::copy_file(source, copy, std::filesystem::copy_options::overwrite_existing, error);
+    if (error) {
+        std::cerr << "Cannot copy " << source << ": " << error.message() << "\n";
+        return 1;
+    }
+    DatabaseConfig config;
+    config.path = copy.string();
+    auto pool = std::make_shared<DatabasePool>(config);
+
+    std::map<int64_t, Row> before = loadRows(pool->primary(), 200);
+    std::vector<Key> keys;
+    for (const auto& [id, row] : before) {
+        if (std::find(keys.begin(), keys.end(), row.key) == keys.end()) keys.push_back(row.key);
+    }
+    if (keys.empty()) {
+        std::cerr << "No responses in " << source << "\n";
+        return 1;
+    }
+
+    // Backend logging goes to stdout; the timings go to stderr
+    pool->primary().exec("DROP INDEX IF EXISTS idx_responses_topic_response;");
+    size_t syncClicks = std::min<size_t>(clicks, 200) & ~size_t(1);  // Even, so the pairs cancel
+    std::cerr << "synchronous UPDATE, no index: " << synchronousClicks(pool->primary(), keys, syncClicks) << " us/click\n";
+
+    bool ok = true;
+    {
+        ResponseVariator bot(pool);  // Creates the index
+        std::cerr << "synchronous UPDATE, indexed:  " << synchronousClicks(pool->primary(), keys, syncClicks) << " us/click\n";
+
+        // Skewed clicks, so popular answers coalesce
+        std::mt19937 rng(7);
+        std::geometric_distribution<size_t> pick(0.05);
+        std::map<Key, double> deltas;
+        auto start = Clock::now();
+        for (size_t i = 0; i < clicks; ++i) {
+            const Key& key = keys[pick(rng) % keys.size()];
+            bool positive = rng() % 3 != 0;
+            bot.updateConfidenceInDatabase(key.first, key.second, positive);
+            deltas[key] += positive ? 0.1 : -0.1;
+        }
+        double enqueueUs = usSince(start) / clicks;
+        auto flushStart = Clock::now();
+        bot.flushFeedback();
+        std::cerr << "write-behind enqueue:         " << enqueueUs << " us/click, flush " << usSince(flushStart) / 1000.0 << " ms\n";
+
+        auto stats = bot.getFeedbackStats();
+        std::cerr << "counters: " << stats.received << " received, " << stats.coalesced << " coalesced, " << stats.flushes
+                  << " flushes, " << stats.rowsWritten << " rows written, flush mean " << stats.totalFlushMs / std::max<uint64_t>(stats.flushes, 1)
+                  << " ms / max " << stats.maxFlushMs << " ms, " << stats.queued << " queued\n";
+
+        // Every row with a clicked (topic, response) carries that key's summed delta
+        std::map<int64_t, Row> after = loadRows(pool->primary(), 200);
+        for (const auto& [id, row] : before) {
+            double expected = row.confidence + deltas[row.key];
+            if (std::fabs(after[id].confidence - expected) > 1e-6) {
+                std::cerr << "MISMATCH for row " << id << ": " << after[id].confidence << " vs " << expected << "\n";
+                ok = false;
+            }
+        }
+
+        // Feedback typed differently from every stored spelling reaches all of them
+        std::string key, response;
+        if (findRespelledPair(pool->primary(), key, response)) {
+            std::string input = "  " + key + " ";
+            for (char& c : input) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+            auto rowsBefore = rowsFor(pool->primary(), key, response);
+            bot.updateConfidenceInDatabase(input, response, true);
+            bot.flushFeedback();
+            auto rowsAfter = rowsFor(pool->primary(), key, response);
+
+            bool moved = rowsAfter.size() == rowsBefore.size();
+            for (size_t i = 0; moved && i < rowsAfter.size(); ++i) {
+                moved = std::fabs(rowsAfter[i].second - rowsBefore[i].second - 0.1) < 1e-6;
+            }
+            // The index answers with the first row loaded, i.e. the lowest id
+            double inMemory = bot.getConfidenceForResponse(input, response);
+            bool coherent = moved && !rowsAfter.empty() && std::fabs(inMemory - rowsAfter.front().second) < 1e-5;
+            std::cerr << "feedback via \"" << input << "\" on " << rowsAfter.size() << " rows stored as "
+                      << rowsAfter.front().first << "...: " << (coherent ? "memory and database agree" : "MEMORY AND DATABASE DIFFER") << "\n";
+            ok = ok && coherent;
+        } else {
+            std::cerr << "no topic stored under several spellings; re-spelled feedback not checked\n";
+        }
+    }
+
+    pool.reset();
+    std::filesystem::remove(copy, error);
+    std::filesystem::remove(copy.string() + "-wal", error);
+    std::filesystem::remove(copy.string() + "-shm", error);
+    std::cerr << (ok ? "flushed confidences match" : "flushed confidences DIFFER") << "\n";
+    return ok ? 0 : 1;
+}
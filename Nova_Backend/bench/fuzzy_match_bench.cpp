@@ -0,0 +1,120 @@
+// Compares the BK-tree fuzzy topic lookup against the original full-table
+// Levenshtein scan over `SELECT topic FROM responses`.
+//
+// Usage: fuzzy_match_bench [path/to/chatbot.db] [queries]
+#include "../include/Humanizer/TopicIndex.hpp"
+#include <sqlite3.h>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    // The original per-comparison kernel: a full (n+1)x(m+1) matrix
+    int matrixLevenshtein(const std::string& a, const std::string& b) {
+        std::vector<std::vector<int>> dist(a.size() + 1, std::vector<int>(b.size() + 1));
+        for (size_t i = 0; i <= a.size(); ++i) {
+            for (size_t j = 0; j <= b.size(); ++j) {
+                if (i == 0) dist[i][j] = static_cast<int>(j);
+                else if (j == 0) dist[i][j] = static_cast<int>(i);
+                else dist[i][j] = std::min({dist[i - 1][j] + 1, dist[i][j - 1] + 1,
+                                            dist[i - 1][j - 1] + (a[i - 1] != b[j - 1])});
+            }
+        }
+        return dist[a.size()][b.size()];
+    }
+
+    // The original findSimilarWord: re-query and scan every row per lookup
+    std::string scanSimilar(sqlite3* db, const std::string& input) {
+        std::string closest;
+        int minDistance = INT_MAX;
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, "SELECT topic FROM responses;", -1, &stmt, nullptr) == SQLITE_OK) {
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                const unsigned char* text = sqlite3_column_text(stmt, 0);
+                if (!text) continue;
+                std::string word = reinterpret_cast<const char*>(text);
+                int d = matrixLevenshtein(input, word);
+                if (d < minDistance) {
+                    minDistance = d;
+                    closest = word;
+                }
+            }
+            sqlite3_finalize(stmt);
+        }
+        return minDistance < 3 ? closest : "";
+    }
+
+    std::vector<std::string> buildQueries(sqlite3* db, size_t count) {
+        std::vector<std::string> topics;
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, "SELECT DISTINCT topic FROM responses;", -1, &stmt, nullptr) == SQLITE_OK) {
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                if (const unsigned char* text = sqlite3_column_text(stmt, 0)) {
+                    topics.emplace_back(reinterpret_cast<const char*>(text));
+                }
+            }
+            sqlite3_finalize(stmt);
+        }
+
+        // Mix of typos (one deletion or substitution) and strings with no near match
+        std::vector<std::string> queries;
+        for (size_t i = 0; i < count && !topics.empty(); ++i) {
+            std::string q = topics[(i * 7919) % topics.size()];
+            switch (i % 3) {
+                case 0: if (q.size() > 1) q.erase(q.size() / 2, 1); break;
+                case 1: if (!q.empty()) q[q.size() / 2] = 'x'; break;
+                default: std::reverse(q.begin(), q.end()); q += " zq"; break;
+            }
+            queries.push_back(q);
+        }
+        return queries;
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string dbPath = argc > 1 ? argv[1] : "chatbot.db";
+    size_t queryCount = argc > 2 ? std::stoul(argv[2]) : 60;
+
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        return 1;
+    }
+
+    auto queries = buildQueries(db, queryCount);
+
+    auto start = std::chrono::steady_clock::now();
+    TopicIndex index;
+    index.load(db);
+    double buildMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    size_t scanFound = 0;
+    for (const auto& q : queries) {
+        if (!scanSimilar(db, q).empty()) ++scanFound;
+    }
+    double scanMs = elapsedMs(start);
+
+    start = std::chrono::steady_clock::now();
+    size_t indexFound = 0;
+    for (const auto& q : queries) {
+        if (!index.findSimilar(q, 2).empty()) ++indexFound;
+    }
+    double indexMs = elapsedMs(start);
+
+    std::cout << "queries:            " << queries.size() << "\n"
+              << "index build:        " << buildMs << " ms\n"
+              << "full scan:          " << scanMs / queries.size() << " ms/query (" << scanFound << " matched)\n"
+              << "bk-tree:            " << indexMs / queries.size() << " ms/query (" << indexFound << " matched)\n"
+              << "speedup:            " << (indexMs > 0 ? scanMs / indexMs : 0.0) << "x" << std::endl;
+
+    sqlite3_close(db);
+    return 0;
+}
@@ -0,0 +1,213 @@
+// The ResponseCache in front of ResponseVariator's exact -> fuzzy -> NN chain,
+// on the phrases of datasets/intents.csv replayed with a skew towards the
+// common ones, some misspelled and some never seen (the NN path). Times the
+// chain with the cache emptied before every request against the cached chain
+// and reports hit rate, evictions and bytes.
+//
+// Then teaches, gives feedback and bulk-imports a CSV, and checks that every
+// phrase gets the same answer from the cache as from the uncached chain, with
+// the conversation RNG seeded alike. Fails on any difference.
+//
+// Last, imports a CSV whose COMMIT is refused (a trigger leaves a dangling
+// deferred foreign key) and checks that its rows reached neither the
+// database nor the topic index.
+//
+// Runs on a temporary copy of the database, since the writes change it.
+//
+// Usage: response_cache_bench [path/to/chatbot.db] [path/to/intents.csv] [requests]
+#include "../include/Humanizer/ResponseVariator.hpp"
+#include "../include/Core/CsvReader.hpp"
+#include <sqlite3.h>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::string> loadPhrases(const std::string& csvPath) {
+        std::set<std::string> unique;
+        std::ifstream file(csvPath, std::ios::binary);
+        CsvReader reader(file);
+        std::vector<std::string> fields;
+        bool header = true;
+        while (reader.next(fields)) {
+            if (header) { header = false; continue; }
+            if (fields.size() > 1 && !fields[1].empty()) unique.insert(fields[1]);
+        }
+        return std::vector<std::string>(unique.begin(), unique.end());
+    }
+
+    // Phrases drawn with a skew towards the first ones; every 10th misspelled, every 20th unseen
+    std::vector<std::string> makeTraffic(const std::vector<std::string>& phrases, size_t requests) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::vector<std::string> traffic;
+        traffic.reserve(requests);
+        for (size_t i = 0; i < requests; ++i) {
+            double u = uniform(rng);
+            std::string input = phrases[static_cast<size_t>(u * u * u * phrases.size())];
+            if (i % 20 == 19) {
+                input = "qzxv unseen " + std::to_string(i % 200);
+            } else if (i % 10 == 9 && input.size() > 4) {
+                input.erase(input.size() / 2, 1);
+            }
+            traffic.push_back(std::move(input));
+        }
+        return traffic;
+    }
+
+    double run(ResponseVariator& bot, const std::vector<std::string>& traffic, bool cached) {
+        ResponseVariator::Conversation conversation;
+        conversation.rng.seed(7);
+        auto start = Clock::now();
+        for (const auto& input : traffic) {
+            if (!cached) bot.clearResponseCache();
+            bot.getResponse(input, conversation);
+        }
+        return std::chrono::duration<double, std::micro>(Clock::now() - start).count() / traffic.size();
+    }
+
+    // One fresh conversation per phrase, so both passes consume the same random numbers
+    std::vector<std::string> answers(ResponseVariator& bot, const std::vector<std::string>& inputs, bool cached) {
+        std::vector<std::string> result;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (!cached) bot.clearResponseCache();
+            ResponseVariator::Conversation conversation;
+            conversation.rng.seed(static_cast<unsigned>(i));
+            result.push_back(bot.getResponse(inputs[i], conversation));
+        }
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string source = argc > 1 ? argv[1] : "chatbot.db";
+    std::string csvPath = argc > 2 ? argv[2] : "datasets/intents.csv";
+    size_t requests = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 20000;
+
+    std::vector<std::string> phrases = loadPhrases(csvPath);
+    if (phrases.empty()) {
+        std::cerr << "No phrases in " << csvPath << "\n";
+        return 1;
+    }
+
+    auto copy = std::filesystem::temp_directory_path() / "nova_response_cache_bench.db";
+    auto teachCsv = std::filesystem::temp_directory_path() / "nova_response_cache_bench.csv";
+    std::error_code error;
+    std::filesystem::copy_file(source, copy, std::filesystem::copy_options::overwrite_existing, error);
+    if (error) {
+        std::cerr << "Cannot copy " << source << ": " << error.message() << "\n";
+        return 1;
+    }
+
+    size_t mismatches = 0, changed = 0;
+    bool rolledBack = false;
+    {
+        DatabaseConfig config;
+        config.path = copy.string();
+        auto pool = std::make_shared<DatabasePool>(config);
+        ResponseVariator bot(pool);
+        std::cout.setstate(std::ios::failbit);  // The chain logs every stage
+
+        std::vector<std::string> traffic = makeTraffic(phrases, requests);
+        run(bot, traffic, true);  // Warm-up: page cache, allocator, first NN lookups
+        double uncachedUs = run(bot, traffic, false);
+        bot.clearResponseCache();
+        ResponseCache::Stats before = bot.getResponseCacheStats();
+        double cachedUs = run(bot, traffic, true);
+        ResponseCache::Stats after = bot.getResponseCacheStats();
+
+        uint64_t hits = after.hits - before.hits, misses = after.misses - before.misses;
+        std::printf("%zu requests over %zu phrases\n", traffic.size(), phrases.size());
+        std::printf("uncached: %.2f us/request, cached: %.2f us/request (%.1fx)\n", uncachedUs, cachedUs, uncachedUs / cachedUs);
+        std::printf("hit rate %.1f%% (%llu hits, %llu misses), NN answers reused %llu of %llu, %llu evictions\n",
+                    100.0 * hits / (hits + misses), (unsigned long long)hits, (unsigned long long)misses,
+                    (unsigned long long)(after.generatedHits - before.generatedHits),
+                    (unsigned long long)(after.generatedHits - before.generatedHits + after.generatedMisses - before.generatedMisses),
+                    (unsigned long long)(after.evictions - before.evictions));
+        std::printf("%zu of %zu entries, %zu bytes (%.0f per entry)\n", after.entries, after.capacity, after.bytes,
+                    after.entries ? double(after.bytes) / after.entries : 0.0);
+
+        // Every phrase with its misspelling, the new topics and an input only a new topic fuzzy-matches
+        std::vector<std::string> inputs = phrases;
+        for (const auto& phrase : phrases) {
+            if (phrase.size() > 4) inputs.push_back(std::string(phrase).erase(phrase.size() / 2, 1));
+        }
+        inputs.push_back("qzxv unseen 7");
+        inputs.push_back("qzxv brand new topc");
+        inputs.push_back("qzxv bulk topic");
+        std::vector<std::string> warm = answers(bot, inputs, true);
+
+        // Teaching, feedback and a bulk import on topics the cache now holds
+        const std::string& taught = phrases[0];
+        const std::string& rated = phrases[1];
+        bot.teachAlternative(taught, "a taught alternative");
+        for (int i = 0; i < 20; ++i) bot.updateConfidenceInDatabase(taught, "a taught alternative", true);
+        for (int i = 0; i < 20; ++i) bot.updateConfidenceInDatabase(rated, warm[1], false);
+        bot.addResponse("qzxv brand new topic", "a new topic");
+        {
+            std::ofstream csv(teachCsv);
+            csv << "intent,text,response,weight\n"
+                << "bench," << phrases[2] << ",a bulk reply,1.0\n"
+                << "bench,qzxv bulk topic,a bulk topic,1.0\n";
+        }
+        bot.bulkTeachFromCSV(teachCsv.string());
+
+        std::vector<std::string> cached = answers(bot, inputs, true);
+        std::vector<std::string> uncached = answers(bot, inputs, false);
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            if (cached[i] != uncached[i]) {
+                if (mismatches++ < 5) std::fprintf(stderr, "stale: \"%s\" -> \"%s\", expected \"%s\"\n",
+                                                   inputs[i].c_str(), cached[i].c_str(), uncached[i].c_str());
+            }
+            if (warm[i] != uncached[i]) changed++;
+        }
+        std::cout.clear();
+        std::printf("after teaching and feedback: %zu of %zu answers changed, %zu stale (%llu invalidations)\n",
+                    changed, inputs.size(), mismatches,
+                    (unsigned long long)bot.getResponseCacheStats().invalidations);
+
+        // An import whose COMMIT fails must leave the index as it was
+        Database& db = pool->primary();
+        db.exec("PRAGMA foreign_keys = ON;");
+        db.exec("CREATE TABLE bench_parent (id INTEGER PRIMARY KEY);");
+        db.exec("CREATE TABLE bench_guard (parent INTEGER REFERENCES bench_parent(id) DEFERRABLE INITIALLY DEFERRED);");
+        db.exec("CREATE TRIGGER bench_poison AFTER INSERT ON responses WHEN NEW.topic = 'qzxv poisoned' "
+                "BEGIN INSERT INTO bench_guard VALUES (1); END;");
+        {
+            std::ofstream csv(teachCsv);
+            csv << "intent,text,response,weight\n"
+                << "bench,qzxv lost import topic,a lost reply,1.0\n"
+                << "bench,qzxv poisoned,a poisoned reply,1.0\n";
+        }
+        std::cerr.setstate(std::ios::failbit);  // The expected SQL and rollback errors
+        std::cout.setstate(std::ios::failbit);
+        bot.bulkTeachFromCSV(teachCsv.string());
+        std::cerr.clear();
+
+        ResponseVariator::Conversation conversation;
+        bool indexed = !bot.getIndexedResponse("qzxv lost import topic", conversation).empty();
+        std::cout.clear();
+        int stored = -1;
+        auto count = db.prepare("SELECT COUNT(*) FROM responses WHERE topic = 'qzxv lost import topic';");
+        if (count && count.step() == SQLITE_ROW) stored = sqlite3_column_int(count, 0);
+        rolledBack = !indexed && stored == 0 && sqlite3_get_autocommit(db.handle());
+        std::printf("import with a failed commit: %s\n", rolledBack ? "rolled back, index unchanged"
+                    : indexed ? "ROWS REACHED THE INDEX" : "ROWS REACHED THE DATABASE");
+    }
+
+    std::filesystem::remove(teachCsv, error);
+    std::filesystem::remove(copy, error);
+    std::filesystem::remove(copy.string() + "-wal", error);
+    std::filesystem::remove(copy.string() + "-shm", error);
+    std::filesystem::remove(copy.string() + ".words.hnsw", error);
+    return mismatches == 0 && changed > 0 && rolledBack ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+// Concurrent sessions against one ChatBotController: N threads, each with its
+// own session, answer a mix of known topics and unseen phrases (the NN path).
+// Reports throughput and speedup over one thread, then repeats the widest run
+// while feedback and teaching are queued to the worker, and reports how long
+// those writes take to drain. Fails if any reply comes back empty.
+//
+// Runs on a temporary copy of the database, since the writes change it.
+//
+// Usage: session_bench [path/to/chatbot.db] [requests per thread]
+#include "../include/Controller.hpp"
+#include <sqlite3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<std::string> loadTopics(const std::string& dbPath, size_t limit) {
+        std::vector<std::string> topics;
+        sqlite3* db;
+        if (sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK) {
+            sqlite3_stmt* stmt;
+            if (sqlite3_prepare_v2(db, "SELECT DISTINCT topic FROM responses WHERE topic <> '' LIMIT ?;", -1, &stmt, nullptr) == SQLITE_OK) {
+                sqlite3_bind_int64(stmt, 1, static_cast<sqlite3_int64>(limit));
+                while (sqlite3_step(stmt) == SQLITE_ROW) topics.emplace_back(reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)));
+                sqlite3_finalize(stmt);
+            }
+        }
+        sqlite3_close(db);
+        return topics;
+    }
+
+    struct RunResult {
+        double requestsPerSec = 0.0;
+        size_t empty = 0;
+        size_t writes = 0;
+        double drainMs = 0.0;  // From the last reader finishing to the last queued write applied
+    };
+
+    RunResult run(ChatBotController& controller, const std::vector<std::string>& topics, size_t threads, size_t perThread,
+                  bool withWrites) {
+        std::atomic<size_t> empty{0};
+        std::atomic<bool> done{false};
+
+        // Feedback and teaching keep arriving while the sessions read
+        size_t writes = 0;
+        std::thread writer([&] {
+            while (withWrites && !done.load()) {
+                const std::string& topic = topics[writes % topics.size()];
+                if (writes % 8 == 7) {
+                    controller.submitTeach(topic + " again=" + topic);
+                } else {
+                    controller.submitFeedback(topic, topic, writes % 2 == 0);
+                }
+                writes++;
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+
+        auto start = Clock::now();
+        std::vector<std::thread> sessions;
+        for (size_t t = 0; t < threads; ++t) {
+            sessions.emplace_back([&, t] {
+                auto session = controller.openSession();
+                for (size_t i = 0; i < perThread; ++i) {
+                    // One in five requests misses the topic index and runs the NN stage
+                    std::string input = i % 5 == 4 ? "qzxv unseen " + std::to_string(i) : topics[(t * 7919 + i) % topics.size()];
+                    if (controller.getChatbotResponse(session, input).empty()) empty++;
+                }
+                controller.closeSession(session);
+            });
+        }
+        for (auto& session : sessions) session.join();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        done = true;
+        writer.join();
+
+        // Requests queue behind the posted writes, so this returns once they have all run
+        auto finished = Clock::now();
+        controller.requestResponse(topics.front()).get();
+
+        RunResult result;
+        result.drainMs = std::chrono::duration<double, std::milli>(Clock::now() - finished).count();
+        result.requestsPerSec = threads * perThread / seconds;
+        result.empty = empty.load();
+        result.writes = writes;
+        return result;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string source = argc > 1 ? argv[1] : "chatbot.db";
+    size_t perThread = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+
+    auto copy = std::filesystem::temp_directory_path() / "nova_session_bench.db";
+    std::error_code error;
+    std::filesystem::copy_file(source, copy, std::filesystem::copy_options::overwrite_existing, error);
+    if (error) {
+        std::cerr << "Cannot copy " << source << ": " << error.message() << "\n";
+        return 1;
+    }
+
+    std::vector<std::string> topics = loadTopics(copy.string(), 500);
+    if (topics.empty()) {
+        std::cerr << "No topics in " << source << "\n";
+        return 1;
+    }
+
+    size_t failures = 0;
+    {
+        DatabaseConfig config;
+        config.path = copy.string();
+        ChatBotController controller(std::make_shared<DatabasePool>(config));
+        controller.initialize("");
+        controller.waitUntilReady();
+
+        // Per-request logging would serialize the threads on stdout
+        std::cout.setstate(std::ios::failbit);
+
+        size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        size_t maxThreads = std::max<size_t>(cores * 2, 4);
+        run(controller, topics, 1, perThread, false);  // Warm-up: page cache, allocator, first NN lookups
+        double baseline = 0.0;
+        std::cerr << "threads  requests/s  speedup  (" << cores << " hardware threads)\n";
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            RunResult result = run(controller, topics, threads, perThread, false);
+            if (threads == 1) baseline = result.requestsPerSec;
+            failures += result.empty;
+            std::cerr << threads << "\t " << static_cast<long>(result.requestsPerSec) << "\t     "
+                      << result.requestsPerSec / baseline << "x"
+                      << (result.empty ? "  EMPTY REPLIES: " + std::to_string(result.empty) : "") << "\n";
+        }
+
+        RunResult mixed = run(controller, topics, maxThreads, perThread, true);
+        failures += mixed.empty;
+        std::cerr << maxThreads << " threads with writes: " << static_cast<long>(mixed.requestsPerSec) << " requests/s, "
+                  << mixed.writes << " writes queued, drained " << mixed.drainMs << " ms after the readers"
+                  << (mixed.empty ? ", EMPTY REPLIES: " + std::to_string(mixed.empty) : "") << "\n";
+        std::cout.clear();
+    }
+
+    std::filesystem::remove(copy, error);
+    std::filesystem::remove(copy.string() + "-wal", error);
+    std::filesystem::remove(copy.string() + "-shm", error);
+    std::filesystem::remove(copy.string() + ".words.hnsw", error);
+    return failures == 0 ? 0 : 1;
+}
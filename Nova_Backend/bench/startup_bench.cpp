@@ -0,0 +1,82 @@
+// Time-to-first-response of ChatBotController's staged startup against the
+// previous synchronous sequence (eager NeuralNet, then model load/import).
+//
+// Usage: startup_bench [path/to/chatbot.db] [model file]
+#include "../include/Controller.hpp"
+#include <sqlite3.h>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    double msSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::string firstTopic(const std::string& dbPath) {
+        std::string topic;
+        sqlite3* db;
+        if (sqlite3_open_v2(dbPath.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) == SQLITE_OK) {
+            sqlite3_stmt* stmt;
+            if (sqlite3_prepare_v2(db, "SELECT topic FROM responses WHERE topic <> '' LIMIT 1;", -1, &stmt, nullptr) == SQLITE_OK) {
+                if (sqlite3_step(stmt) == SQLITE_ROW) topic = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
+                sqlite3_finalize(stmt);
+            }
+        }
+        sqlite3_close(db);
+        return topic;
+    }
+
+    std::shared_ptr<DatabasePool> openPool(const std::string& dbPath) {
+        DatabaseConfig config;
+        config.path = dbPath;
+        return std::make_shared<DatabasePool>(config);
+    }
+
+    void synchronous(const std::string& dbPath, const std::string& modelFile, const std::string& known) {
+        auto start = Clock::now();
+        ResponseVariator bot(openPool(dbPath));
+        bot.neuralNet.loadModelFromFile(modelFile);
+        bot.neuralNet.importModelToDatabase(modelFile);
+        double ready = msSince(start);
+        bot.getResponse(known);
+        std::cerr << "synchronous: first response " << msSince(start) << " ms (ready " << ready << " ms)\n";
+    }
+
+    void staged(const std::string& dbPath, const std::string& modelFile, const std::string& known) {
+        auto start = Clock::now();
+        ChatBotController controller(openPool(dbPath));
+        controller.initialize(modelFile);
+        double initialized = msSince(start);
+        controller.getChatbotResponse(known);
+        double firstResponse = msSince(start);
+        bool readyBeforeFirst = controller.isReady();
+        controller.waitUntilReady();
+        double ready = msSince(start);
+        controller.getChatbotResponse("qzxv unseen words");  // Misses the index, so it needs the NN
+        std::cerr << "staged: initialize returned " << initialized << " ms, first response " << firstResponse
+                  << " ms (startup " << (readyBeforeFirst ? "already" : "still not") << " done), ready " << ready
+                  << " ms, first NN response " << msSince(start) << " ms\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string dbPath = argc > 1 ? argv[1] : "chatbot.db";
+    std::string modelFile = argc > 2 ? argv[2] : "trained_model.bin";
+    std::string known = firstTopic(dbPath);
+    if (known.empty()) {
+        std::cerr << "No topics in " << dbPath << "\n";
+        return 1;
+    }
+
+    // Backend logging goes to stdout; the timings go to stderr
+    synchronous(dbPath, modelFile, known);  // Warms the page cache and creates the model file if missing
+    for (int run = 0; run < 3; ++run) {
+        synchronous(dbPath, modelFile, known);
+        staged(dbPath, modelFile, known);
+    }
+    return 0;
+}
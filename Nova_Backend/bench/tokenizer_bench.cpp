@@ -0,0 +1,185 @@
+// Allocations and time per message for the shared Tokenizer against the four
+// tokenizers it replaced (NeuralNet's whitespace split, WordVectorHelper,
+// TopicExtractor and ContextTracker), over the text and response columns of
+// intents.csv. Also counts the messages where the old and new spellings differ.
+//
+// Usage: tokenizer_bench [path/to/intents.csv] [passes]
+#include "../include/Core/Tokenizer.hpp"
+#include "../include/Core/CsvReader.hpp"
+#include "../include/Core/TopicExtractor.hpp"
+#include "../include/Core/WordVectorHelper.hpp"
+#include "../include/Humanizer/ContextTracker.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+    std::atomic<bool> countAllocations{false};
+    std::atomic<size_t> allocations{0};
+}
+
+void* operator new(size_t size) {
+    if (countAllocations.load(std::memory_order_relaxed)) allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // The tokenizers as they were before Tokenizer.
+    // NeuralNet already split without copying, but looked up the raw spelling
+    size_t oldNeuralNetSplit(const std::string& text) {
+        size_t count = 0, i = 0;
+        while (i < text.size()) {
+            while (i < text.size() && std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+            size_t start = i;
+            while (i < text.size() && !std::isspace(static_cast<unsigned char>(text[i]))) ++i;
+            count += i - start;
+        }
+        return count;
+    }
+
+    std::vector<std::string> oldWordVectorTokenize(const std::string& input) {
+        std::vector<std::string> tokens;
+        std::string word;
+        std::string processed = input;
+        std::transform(processed.begin(), processed.end(), processed.begin(), ::tolower);
+        std::istringstream stream(processed);
+        while (stream >> word) {
+            word.erase(std::remove_if(word.begin(), word.end(), ::ispunct), word.end());
+            tokens.push_back(word);
+        }
+        return tokens;
+    }
+
+    std::vector<std::string> oldTopicExtract(const std::string& input) {
+        static const std::map<std::string, std::string> aliasMap = {
+            {"bye", "goodbye"}, {"hi", "hello"}, {"hey", "hello"}, {"thanks", "thank"},
+            {"okay", "ok"}, {"yeah", "yes"}, {"nope", "no"}, {"yep", "yes"}
+        };
+        static const std::set<std::string> stopwords = {
+            "the", "is", "in", "and", "or", "a", "an", "to", "for", "with",
+            "on", "at", "by", "of", "that", "this", "it", "as", "are", "was", "be"
+        };
+        std::istringstream iss(input);
+        std::string word;
+        std::vector<std::string> keywords;
+        while (iss >> word) {
+            std::string cleaned;
+            for (char c : word) {
+                if (std::isalnum(c)) cleaned += std::tolower(c);
+            }
+            auto it = aliasMap.find(cleaned);
+            std::string norm = it != aliasMap.end() ? it->second : cleaned;
+            if (!norm.empty() && !stopwords.count(norm)) keywords.push_back(norm);
+        }
+        return keywords;
+    }
+
+    std::set<std::string> oldContextKeywords(const std::string& message) {
+        std::set<std::string> keywords;
+        std::istringstream iss(message);
+        std::string word;
+        while (iss >> word) {
+            if (word.size() > 3) keywords.insert(word);
+        }
+        return keywords;
+    }
+
+    template <typename F>
+    void measure(const char* name, const std::vector<std::string>& messages, int passes, F&& f) {
+        size_t sink = 0;
+        for (const auto& message : messages) sink += f(message);  // Warm-up, grows reused buffers
+        allocations = 0;
+        countAllocations = true;
+        auto start = Clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (const auto& message : messages) sink += f(message);
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        countAllocations = false;
+        double runs = static_cast<double>(messages.size()) * passes;
+        std::printf("  %-34s %7.2f allocs/msg %9.1f ns/msg   (%zu)\n", name, allocations / runs, ns / runs, sink % 10);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "datasets/intents.csv";
+    int passes = argc > 2 ? std::atoi(argv[2]) : 20;
+
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "Cannot open " << path << std::endl;
+        return 1;
+    }
+    CsvReader reader(file);
+    std::vector<std::string> fields;
+    std::vector<std::string> messages;
+    reader.next(fields);  // Header
+    while (reader.next(fields)) {
+        if (fields.size() > 2) {
+            messages.push_back(fields[1]);
+            messages.push_back(fields[2]);
+        }
+    }
+    if (messages.empty()) {
+        std::cerr << "No messages in " << path << std::endl;
+        return 1;
+    }
+    std::printf("%zu messages from %s, %d passes\n", messages.size(), path.c_str(), passes);
+
+    std::printf("before:\n");
+    measure("NeuralNet split (raw views)", messages, passes, oldNeuralNetSplit);
+    measure("WordVectorHelper::tokenize", messages, passes, [](const std::string& m) { return oldWordVectorTokenize(m).size(); });
+    measure("TopicExtractor::extract", messages, passes, [](const std::string& m) { return oldTopicExtract(m).size(); });
+    measure("ContextTracker::extractKeywords", messages, passes, [](const std::string& m) { return oldContextKeywords(m).size(); });
+
+    ContextTracker tracker;
+    std::printf("after:\n");
+    measure("Tokenizer::local().tokenize", messages, passes, [](const std::string& m) {
+        size_t count = 0;
+        for (const auto& token : Tokenizer::local().tokenize(m)) count += token.text.size();
+        return count;
+    });
+    measure("WordVectorHelper::tokenize", messages, passes, [](const std::string& m) { return WordVectorHelper::tokenize(m).size(); });
+    measure("TopicExtractor::extract", messages, passes, [](const std::string& m) { return TopicExtractor::extract(m).size(); });
+    measure("ContextTracker::extractKeywords", messages, passes, [&](const std::string& m) { return tracker.extractKeywords(m).size(); });
+
+    // Where the spellings moved: the old WordVectorHelper kept UTF-8 punctuation and empty tokens,
+    // the old TopicExtractor dropped every non-ASCII byte
+    size_t wordVectorDiffers = 0, topicDiffers = 0;
+    std::string example;
+    for (const auto& message : messages) {
+        auto before = oldWordVectorTokenize(message);
+        before.erase(std::remove(before.begin(), before.end(), std::string()), before.end());
+        if (before != WordVectorHelper::tokenize(message)) {
+            wordVectorDiffers++;
+            if (example.empty()) example = message;
+        }
+        if (oldTopicExtract(message) != TopicExtractor::extract(message)) topicDiffers++;
+    }
+    std::printf("spelling changes: WordVectorHelper %zu, TopicExtractor %zu of %zu messages\n",
+                wordVectorDiffers, topicDiffers, messages.size());
+    if (!example.empty()) {
+        std::printf("  e.g. \"%s\" ->", example.c_str());
+        for (const auto& token : Tokenizer::local().tokenize(example)) {
+            std::printf(" [%.*s]", static_cast<int>(token.text.size()), token.text.data());
+        }
+        std::printf("\n");
+    }
+    return 0;
+}
@@ -0,0 +1,63 @@
+// Times each VectorMath kernel per ISA at the embedding sizes the model uses,
+// and on either side of the scalar cutoff. tests/vector_math_test checks that
+// the ISAs agree.
+//
+// Usage: vector_math_bench [iterations]
+#include "../include/Core/VectorMath.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    const VectorMath::Isa kIsas[] = { VectorMath::Isa::Scalar, VectorMath::Isa::SSE4, VectorMath::Isa::AVX2 };
+
+    template <typename F>
+    double timeNs(size_t iterations, F&& kernel) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i) kernel();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+    }
+
+    void timeKernels(size_t dim, size_t iterations, std::mt19937& rng) {
+        std::normal_distribution<float> dist(0.0f, 1.0f);
+        std::vector<float> a(dim), b(dim), out(dim);
+        for (size_t i = 0; i < dim; ++i) {
+            a[i] = dist(rng);
+            b[i] = dist(rng);
+        }
+
+        for (VectorMath::Isa isa : kIsas) {
+            if (!VectorMath::setIsa(isa)) continue;
+            volatile float sink = 0.0f;
+            double dotNs = timeNs(iterations, [&] { sink = sink + VectorMath::dot(a.data(), b.data(), dim); });
+            double normNs = timeNs(iterations, [&] { sink = sink + VectorMath::norm(a.data(), dim); });
+            double cosineNs = timeNs(iterations, [&] { sink = sink + VectorMath::cosine(a.data(), b.data(), dim); });
+            double mseNs = timeNs(iterations, [&] { sink = sink + VectorMath::mse(a.data(), b.data(), dim); });
+            double axpyNs = timeNs(iterations, [&] { VectorMath::axpy(1e-7f, a.data(), out.data(), dim); });
+            double mulNs = timeNs(iterations, [&] { VectorMath::mul(a.data(), b.data(), out.data(), dim); });
+            sink = sink + out[0];
+
+            std::cout << std::setw(5) << dim << std::setw(10) << VectorMath::name(isa) << std::fixed << std::setprecision(1)
+                      << std::setw(9) << dotNs << std::setw(9) << normNs << std::setw(9) << cosineNs
+                      << std::setw(9) << mseNs << std::setw(9) << axpyNs << std::setw(9) << mulNs << "\n";
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    size_t iterations = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    std::mt19937 rng(7);
+    VectorMath::Isa detected = VectorMath::isa();
+    std::cout << "Detected: " << VectorMath::name(detected) << "\n\n";
+
+    std::cout << "  dim       isa   dot ns  norm ns   cos ns   mse ns  axpy ns   mul ns\n";
+    for (size_t dim : { 3, 7, 8, 50, 100, 300 }) timeKernels(dim, iterations, rng);
+
+    VectorMath::setIsa(detected);
+    return 0;
+}
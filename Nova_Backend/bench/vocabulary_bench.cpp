@@ -0,0 +1,172 @@
+// Heap held by the word tables of chatbot.db before and after the global
+// Vocabulary: the previous EmbeddingStore (a std::string per word plus a
+// string-keyed hash map) and the per-token std::unordered_map mirrors
+// NeuralNet filled as it trained, against the interned vocabulary with
+// id-indexed flat arrays. Also checks that every word finds the same vector
+// and times the lookups.
+//
+// Usage: vocabulary_bench [path/to/chatbot.db] [lookup passes]
+#include "../include/Core/EmbeddingStore.hpp"
+#include "../include/Core/Vocabulary.hpp"
+#include "../include/Core/VectorCodec.hpp"
+#include <sqlite3.h>
+#include <malloc.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    std::atomic<long long> liveBytes{0};  // Usable size of every live allocation
+
+    void* allocate(size_t size) {
+        if (void* p = std::malloc(size ? size : 1)) {
+            liveBytes.fetch_add(static_cast<long long>(malloc_usable_size(p)), std::memory_order_relaxed);
+            return p;
+        }
+        throw std::bad_alloc();
+    }
+
+    void release(void* p) noexcept {
+        if (p) liveBytes.fetch_sub(static_cast<long long>(malloc_usable_size(p)), std::memory_order_relaxed);
+        std::free(p);
+    }
+}
+
+// Every form the program can call, each pair going through the same two
+// functions, so no allocation is counted by one form and freed by another
+void* operator new(size_t size) { return allocate(size); }
+void* operator new[](size_t size) { return allocate(size); }
+void operator delete(void* p) noexcept { release(p); }
+void operator delete[](void* p) noexcept { release(p); }
+void operator delete(void* p, size_t) noexcept { release(p); }
+void operator delete[](void* p, size_t) noexcept { release(p); }
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // EmbeddingStore as it was: its own copy of every word and a string_view-keyed map
+    struct PreviousStore {
+        explicit PreviousStore(int dim) : dim(dim) {}
+
+        int dim;
+        std::deque<std::string> words;
+        std::unordered_map<std::string_view, uint32_t> ids;
+        std::vector<float> matrix;
+
+        void set(const std::string& word, const std::vector<float>& vector) {
+            auto it = ids.find(word);
+            uint32_t id;
+            if (it != ids.end()) {
+                id = it->second;
+            } else {
+                id = static_cast<uint32_t>(words.size());
+                words.push_back(word);
+                ids.emplace(words.back(), id);
+                matrix.resize(matrix.size() + dim, 0.0f);
+            }
+            std::copy(vector.begin(), vector.begin() + std::min<size_t>(vector.size(), dim), matrix.begin() + size_t(id) * dim);
+        }
+        const float* find(std::string_view word) const {
+            auto it = ids.find(word);
+            return it != ids.end() ? matrix.data() + size_t(it->second) * dim : nullptr;
+        }
+    };
+
+    struct Row {
+        std::string word;
+        std::vector<float> vector;
+    };
+
+    std::vector<Row> readRows(sqlite3* db) {
+        std::vector<Row> rows;
+        sqlite3_stmt* stmt;
+        if (sqlite3_prepare_v2(db, "SELECT word, vector FROM word_vectors;", -1, &stmt, nullptr) == SQLITE_OK) {
+            std::vector<float> vec;
+            while (sqlite3_step(stmt) == SQLITE_ROW) {
+                const unsigned char* word = sqlite3_column_text(stmt, 0);
+                if (word && VectorCodec::readColumn(stmt, 1, vec)) rows.push_back({reinterpret_cast<const char*>(word), vec});
+            }
+            sqlite3_finalize(stmt);
+        }
+        return rows;
+    }
+
+    template <typename F>
+    long long bytesHeldBy(F&& build) {
+        long long before = liveBytes.load();
+        build();
+        return liveBytes.load() - before;
+    }
+
+    template <typename Find>
+    double lookupNs(const std::vector<Row>& rows, int passes, Find&& find) {
+        size_t found = 0;
+        auto start = Clock::now();
+        for (int pass = 0; pass < passes; ++pass) {
+            for (const Row& row : rows) found += find(row.word) != nullptr;
+        }
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        return found == rows.size() * passes ? ns / (rows.size() * passes) : -1.0;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    std::string path = argc > 1 ? argv[1] : "chatbot.db";
+    int passes = argc > 2 ? std::atoi(argv[2]) : 50;
+
+    sqlite3* db = nullptr;
+    if (sqlite3_open_v2(path.c_str(), &db, SQLITE_OPEN_READONLY, nullptr) != SQLITE_OK) {
+        std::cerr << "Can't open database: " << sqlite3_errmsg(db) << std::endl;
+        return 1;
+    }
+    std::vector<Row> rows = readRows(db);
+    sqlite3_close(db);
+    if (rows.empty()) {
+        std::cerr << "No word vectors in " << path << std::endl;
+        return 1;
+    }
+    int dim = static_cast<int>(rows.front().vector.size());
+    std::printf("%zu words, %d dimensions\n", rows.size(), dim);
+
+    PreviousStore previous(dim);
+    std::unordered_map<std::string, std::vector<float>> mirror;  // NeuralNet::wordEmbeddings after training every word
+    long long previousBytes = bytesHeldBy([&] { for (const Row& row : rows) previous.set(row.word, row.vector); });
+    long long mirrorBytes = bytesHeldBy([&] { for (const Row& row : rows) mirror[row.word] = row.vector; });
+
+    EmbeddingStore store(dim);
+    size_t vocabularyBefore = Vocabulary::global().memoryUsage();
+    long long storeBytes = bytesHeldBy([&] { for (const Row& row : rows) store.set(row.word, row.vector); });
+    size_t vocabularyBytes = Vocabulary::global().memoryUsage() - vocabularyBefore;
+
+    long long matrixBytes = static_cast<long long>(rows.size()) * dim * sizeof(float);
+    std::printf("before: EmbeddingStore %lld bytes (%lld excluding the matrix), trained-word mirror +%lld bytes\n",
+                previousBytes, previousBytes - matrixBytes, mirrorBytes);
+    std::printf("after:  EmbeddingStore + Vocabulary %lld bytes (%lld excluding the matrix; vocabulary reports %zu)\n",
+                storeBytes, storeBytes - matrixBytes, vocabularyBytes);
+    std::printf("saved:  %lld bytes at startup, %lld once every word has trained (%.1f -> %.1f bytes per word)\n",
+                previousBytes - storeBytes, previousBytes + mirrorBytes - storeBytes,
+                double(previousBytes + mirrorBytes) / rows.size(), double(storeBytes) / rows.size());
+
+    // Same vector for every word; duplicate spellings keep the last row, in both stores
+    size_t mismatches = 0;
+    for (const Row& row : rows) {
+        const float* a = previous.find(row.word);
+        const float* b = store.find(row.word);
+        if (!a || !b || !std::equal(a, a + dim, b)) mismatches++;
+    }
+
+    std::printf("lookup: previous %.1f ns, vocabulary %.1f ns per word\n",
+                lookupNs(rows, passes, [&](const std::string& w) { return previous.find(w); }),
+                lookupNs(rows, passes, [&](const std::string& w) { return store.find(w); }));
+    std::printf("%s\n", mismatches == 0 ? "every word finds the same vector" : "VECTORS DIFFER");
+    return mismatches == 0 ? 0 : 1;
+}
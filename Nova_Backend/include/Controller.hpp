@@ -1,21 +1,119 @@
 #pragma once
 
 #include <string>
-#include "Core/NeuralNet.hpp"
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <memory>
+#include <unordered_map>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <deque>
+#include <future>
+#include <vector>
+#include <cstdint>
+#include "Core/Database.hpp"
 #include "Humanizer/ResponseVariator.hpp"
 
 class ChatBotController {
 public:
-    ChatBotController();
+    // initialize() returns at once; these stages then run on a background thread
+    enum class StartupStage { NotStarted, LoadingEmbeddings, BuildingIndexes, LoadingModel, ImportingModel, Ready };
+    struct StartupStatus {
+        StartupStage stage = StartupStage::NotStarted;
+        float progress = 0.0f;  // Fraction of the stages finished, 0..1
+        double elapsedMs = 0.0;  // Since initialize()
+    };
+    using StartupCallback = std::function<void(const StartupStatus&)>;  // Called on the startup thread
+
+    // All components share the pool's connection; pass a pool to use another database
+    explicit ChatBotController(std::shared_ptr<DatabasePool> pool = DatabasePool::defaultPool());
     ~ChatBotController();
 
     void teachMode(const std::string& input);
-    void initialize(const std::string& modelFile);
-    std::string getChatbotResponse(const std::string& input);
+    void initialize(const std::string& modelFile, StartupCallback onProgress = {});
+    StartupStatus startupStatus() const;
+    bool isReady() const;
+    void waitUntilReady();  // Runs the startup stages here if initialize() was never called
+    static const char* stageName(StartupStage stage);
+    std::string getChatbotResponse(const std::string& input);  // In the default session
     void provideFeedback(const std::string& input, const std::string& response, bool positive);
     double getConfidenceScore(const std::string& input, const std::string& response);
+    ResponseCache::Stats getResponseCacheStats() const;  // Takes no lock that answering waits on
+
+    // Sessions keep per-user conversation state. Responses for different sessions
+    // run in parallel on the callers' threads; each session answers one turn at a time
+    using SessionId = uint64_t;
+    static constexpr SessionId kDefaultSession = 0;  // Always open; used by the calls without a session
+    SessionId openSession();
+    void closeSession(SessionId session);
+    size_t sessionCount() const;
+    std::string getChatbotResponse(SessionId session, const std::string& input);  // Empty for an unknown session
+
+    // Asynchronous API: requests and posted actions run in order on one worker thread
+    struct Reply {
+        uint64_t id = 0;
+        std::string input;
+        std::string response;  // Empty when cancelled
+        bool cancelled = false;  // Cancelled or superseded before the reply was delivered
+        double queuedMs = 0.0;  // Waiting for the worker
+        double latencyMs = 0.0;  // Submit to reply, queueing included
+    };
+    using ReplyCallback = std::function<void(const Reply&)>;  // Worker thread; the cancelling thread for cancellations
+
+    // supersede cancels every older request that has not replied yet
+    uint64_t submitRequest(const std::string& input, ReplyCallback onReply, bool supersede = false);
+    std::future<Reply> requestResponse(const std::string& input, bool supersede = false);
+    bool cancelRequest(uint64_t id);  // False once the reply has been delivered
+    // The worker is the single writer for sessions: these queue the mutation instead of
+    // making the caller wait for readers to drain
+    void submitFeedback(const std::string& input, const std::string& response, bool positive);
+    void submitTeach(const std::string& input);
 
 private:
-    NeuralNet neuralNet;
-    ResponseVariator bot;
+    ResponseVariator bot;  // Owns the only NeuralNet
+
+    // Until Ready only the topic index answers; everything that touches the NeuralNet waits
+    mutable std::mutex startupMutex;
+    std::condition_variable startupCv;
+    StartupStatus status;
+    std::chrono::steady_clock::time_point startupBegan;
+    StartupCallback startupCallback;
+    std::thread startupThread;
+    void runStartup(const std::string& modelFile);
+    void setStage(StartupStage stage);
+
+    // Answering only reads the shared tables and takes this shared; teaching and
+    // feedback take it exclusively, so they never run next to a reader
+    std::shared_mutex botMutex;
+
+    struct Session {
+        std::mutex turnMutex;
+        ResponseVariator::Conversation conversation;
+    };
+    mutable std::mutex sessionMutex;
+    std::unordered_map<SessionId, std::shared_ptr<Session>> sessions;
+    SessionId nextSessionId = kDefaultSession + 1;
+    std::shared_ptr<Session> findSession(SessionId session) const;
+
+    struct Job {
+        uint64_t id = 0;  // 0 for posted actions
+        std::string input;
+        ReplyCallback onReply;
+        std::function<void()> action;
+        std::chrono::steady_clock::time_point submitted;
+    };
+    std::mutex jobMutex;
+    std::condition_variable jobCv;
+    std::deque<Job> jobs;
+    uint64_t nextRequestId = 1;
+    uint64_t runningId = 0;
+    bool runningCancelled = false;
+    bool stopWorker = false;
+    std::thread worker;
+    void workerLoop();
+    void post(Job job);
+    std::vector<Job> takeRequests(uint64_t olderThan);  // Remove queued requests; caller holds jobMutex
+    static void deliverCancelled(std::vector<Job>& cancelled);
 };
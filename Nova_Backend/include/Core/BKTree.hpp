@@ -0,0 +1,31 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+
+// Burkhard-Keller tree keyed on Levenshtein distance. Lets fuzzy lookups
+// prune whole subtrees via the triangle inequality instead of scanning
+// every known word.
+class BKTree {
+public:
+    void insert(const std::string& word);  // Duplicates are ignored
+    void clear();
+    size_t size() const { return nodes.size(); }
+
+    // Finds the closest word within maxDistance. Ties go to the word that was
+    // inserted first. `visited` (optional) receives the number of distance
+    // computations performed.
+    bool findClosest(const std::string& query, int maxDistance, std::string& out,
+                     int* distance = nullptr, size_t* visited = nullptr) const;
+
+private:
+    struct Node {
+        std::string word;
+        std::vector<std::pair<int, uint32_t>> children;  // (edge distance, node index)
+    };
+
+    std::vector<Node> nodes;  // nodes[0] is the root; index doubles as insertion order
+
+    static int distance(const std::string& a, const std::string& b);  // Full distance, used on insert
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <istream>
+#include <string>
+#include <vector>
+
+// Streaming CSV reader. Quoted fields may contain commas, doubled quotes ("")
+// and line breaks; CRLF line endings and a UTF-8 byte order mark are accepted.
+class CsvReader {
+public:
+    explicit CsvReader(std::istream& in);
+
+    bool next(std::vector<std::string>& fields);  // Reads one record; false at end of input
+    size_t recordNumber() const { return records; }  // Records returned so far
+
+private:
+    std::streambuf* buffer;
+    size_t records = 0;
+};
@@ -0,0 +1,101 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+#include <iosfwd>
+#include <sqlite3.h>
+
+// Connection settings shared by every component. The path defaults to the
+// NOVA_DB_PATH environment variable, falling back to the project database.
+struct DatabaseConfig {
+    std::string path = defaultPath();
+    bool walMode = true;  // Readers keep going while the writer commits
+    int cacheSizeKiB = 32 * 1024;  // Page cache per connection
+    int64_t mmapSize = 256ll * 1024 * 1024;  // Bytes of the file mapped for reads
+    int busyTimeoutMs = 5000;
+
+    static std::string defaultPath();
+};
+
+// Owns one SQLite connection and a cache of prepared statements, so each
+// SQL string is parsed and planned once per connection. Not thread-safe:
+// use one Database per thread.
+class Database {
+    struct CachedStatement;
+
+public:
+    // A prepared statement on loan from the cache. Resets and clears its
+    // bindings when it goes out of scope, ready for the next caller.
+    class Statement {
+    public:
+        Statement() = default;
+        Statement(Statement&& other) noexcept;
+        Statement& operator=(Statement&& other) noexcept;
+        Statement(const Statement&) = delete;
+        Statement& operator=(const Statement&) = delete;
+        ~Statement();
+
+        int step();  // sqlite3_step, timed into the statement's stats
+        sqlite3_stmt* get() const { return stmt; }
+        operator sqlite3_stmt*() const { return stmt; }
+        explicit operator bool() const { return stmt != nullptr; }
+
+    private:
+        friend class Database;
+        sqlite3_stmt* stmt = nullptr;
+        CachedStatement* entry = nullptr;  // nullptr for an uncached one-off statement
+        void release();
+    };
+
+    struct StatementStats {
+        std::string sql;
+        uint64_t executions = 0;
+        double totalMs = 0.0;
+    };
+
+    explicit Database(const DatabaseConfig& config);
+    ~Database();
+    Database(const Database&) = delete;
+    Database& operator=(const Database&) = delete;
+
+    Statement prepare(const std::string& sql);  // Cached; nullptr statement on error
+    bool exec(const char* sql);  // For one-off statements with no results
+    bool isOpen() const { return db != nullptr; }
+    sqlite3* handle() const { return db; }
+    const std::string& path() const { return dbPath; }
+    const char* errorMessage() const { return sqlite3_errmsg(db); }
+
+    std::vector<StatementStats> statementStats() const;  // Sorted by total time, slowest first
+    void printStats(std::ostream& out) const;
+
+private:
+    struct CachedStatement {
+        sqlite3_stmt* stmt = nullptr;
+        bool inUse = false;
+        StatementStats stats;
+    };
+
+    std::string dbPath;
+    sqlite3* db = nullptr;
+    std::unordered_map<std::string, std::unique_ptr<CachedStatement>> cache;
+};
+
+// Hands every component the same primary connection, so the process keeps a
+// single page cache. Background threads get their own connection, since a
+// Database (and its statement cache) must stay on one thread.
+class DatabasePool {
+public:
+    explicit DatabasePool(DatabaseConfig config = DatabaseConfig());
+
+    Database& primary() { return *primaryDb; }  // For the thread that owns the components
+    std::unique_ptr<Database> openConnection() const;  // Extra connection for a worker thread
+    const DatabaseConfig& config() const { return settings; }
+
+    static std::shared_ptr<DatabasePool> defaultPool();  // Process-wide pool for DatabaseConfig()
+
+private:
+    DatabaseConfig settings;
+    std::unique_ptr<Database> primaryDb;
+};
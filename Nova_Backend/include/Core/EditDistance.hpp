@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+
+// Allocation-free Levenshtein kernels.
+//  - myers():    bit-parallel (Myers/Hyyro), shorter string must be <= 64 chars
+//  - bounded():  banded DP that gives up once the distance exceeds maxDistance
+//  - twoRow():   classic rolling-row DP for strings of any length
+class EditDistance {
+public:
+    static int levenshtein(const std::string& a, const std::string& b);  // Picks the best kernel
+    static int myers(const std::string& a, const std::string& b);
+    static int bounded(const std::string& a, const std::string& b, int maxDistance);  // maxDistance + 1 if exceeded
+    static int twoRow(const std::string& a, const std::string& b);
+
+    static const size_t kMaxBitParallel = 64;
+};
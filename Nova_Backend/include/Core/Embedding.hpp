@@ -0,0 +1,92 @@
+#pragma once
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include "VectorMath.hpp"
+
+// Fixed-size embedding for the dimensions the engine is specialized on.
+// Storage is inline and 32-byte aligned, so an Embedding<N> on the stack
+// never touches the heap.
+template <int N>
+struct alignas(32) Embedding {
+    static_assert(N > 0, "Embedding dimension must be positive");
+    static constexpr int kDimension = N;
+
+    float values[N];
+
+    float* data() { return values; }
+    const float* data() const { return values; }
+    float& operator[](int i) { return values[i]; }
+    float operator[](int i) const { return values[i]; }
+    static constexpr int size() { return N; }
+};
+
+// Kernels with the length known at compile time. Small dimensions are
+// unrolled completely; longer ones keep a constant-trip loop the compiler
+// vectorizes, and reductions go through the SIMD VectorMath kernels.
+namespace EmbeddingKernels {
+    constexpr int kUnrollLimit = 16;
+
+    namespace detail {
+        template <typename F, size_t... I>
+        inline void unroll(F&& f, std::index_sequence<I...>) { (f(static_cast<int>(I)), ...); }
+    }
+
+    template <int N, typename F>
+    inline void forEachLane(F&& f) {
+        if constexpr (N <= kUnrollLimit) {
+            detail::unroll(f, std::make_index_sequence<N>{});
+        } else {
+            for (int i = 0; i < N; ++i) f(i);
+        }
+    }
+
+    template <int N>
+    inline void zero(float* out) { forEachLane<N>([&](int i) { out[i] = 0.0f; }); }
+
+    template <int N>
+    inline void add(const float* x, float* y) { forEachLane<N>([&](int i) { y[i] += x[i]; }); }  // y += x
+
+    template <int N>
+    inline void scale(float* y, float factor) { forEachLane<N>([&](int i) { y[i] *= factor; }); }
+
+    template <int N>
+    inline void copy(const float* x, float* y) { forEachLane<N>([&](int i) { y[i] = x[i]; }); }
+
+    template <int N>
+    inline float dot(const float* a, const float* b) {
+        if constexpr (N <= kUnrollLimit) {
+            float sum = 0.0f;
+            forEachLane<N>([&](int i) { sum += a[i] * b[i]; });
+            return sum;
+        } else {
+            return VectorMath::dot(a, b, N);
+        }
+    }
+
+    template <int N>
+    inline float norm(const float* a) {
+        if constexpr (N <= kUnrollLimit) {
+            return std::sqrt(dot<N>(a, a));
+        } else {
+            return VectorMath::norm(a, N);
+        }
+    }
+}
+
+// Dimensions with a compiled specialization
+using SpecializedDimensions = std::integer_sequence<int, 3, 50, 100, 300>;
+
+namespace EmbeddingKernels::detail {
+    template <typename F, int... Dims>
+    inline bool dispatch(int dimension, F&& f, std::integer_sequence<int, Dims...>) {
+        return ((dimension == Dims ? (f(std::integral_constant<int, Dims>{}), true) : false) || ...);
+    }
+}
+
+// Calls f(std::integral_constant<int, N>{}) if `dimension` is specialized; false otherwise
+template <typename F>
+inline bool dispatchDimension(int dimension, F&& f) {
+    return EmbeddingKernels::detail::dispatch(dimension, f, SpecializedDimensions{});
+}
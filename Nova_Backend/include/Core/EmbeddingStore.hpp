@@ -0,0 +1,35 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <sqlite3.h>
+#include "Vocabulary.hpp"
+
+// Resident copy of the word_vectors table: one flat row-major float matrix
+// with `dimension` floats per word, plus flat maps between rows and ids in
+// the global Vocabulary.
+class EmbeddingStore {
+public:
+    explicit EmbeddingStore(int dimension = 3);
+
+    void load(sqlite3* db);  // Replace contents with every row of word_vectors
+    static int detectDimension(sqlite3* db, int fallback);  // Length of the stored vectors; `fallback` if there are none
+    uint32_t set(std::string_view word, const std::vector<float>& vector);  // Insert or overwrite, returns the row
+    const float* find(std::string_view word) const;  // nullptr if the word is unknown
+    const float* find(Vocabulary::Id word) const;  // Same, for a word already looked up in the vocabulary
+    int64_t idOf(std::string_view word) const;  // Row of the word, -1 if it is unknown
+
+    std::string_view word(uint32_t row) const { return Vocabulary::global().word(words[row]); }
+    const float* vector(uint32_t row) const { return matrix.data() + static_cast<size_t>(row) * dim; }
+    size_t size() const { return words.size(); }
+    int dimension() const { return dim; }
+    size_t memoryUsage() const;  // Bytes held by the matrix and row maps (not the shared vocabulary)
+
+private:
+    static constexpr uint32_t kNoRow = UINT32_MAX;
+    int dim;
+    std::vector<Vocabulary::Id> words;  // Row -> vocabulary id
+    std::vector<uint32_t> rows;  // Vocabulary id -> row, kNoRow for words without a vector
+    std::vector<float> matrix;
+};
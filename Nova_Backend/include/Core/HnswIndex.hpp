@@ -0,0 +1,56 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <random>
+#include <cstdint>
+
+// Approximate nearest-neighbour index (Hierarchical Navigable Small World
+// graph) over unit-normalized vectors, keyed by string. Similarity is the
+// dot product, i.e. cosine similarity of the original vectors. Searches may
+// run on several threads at once; insert() needs exclusive access.
+class HnswIndex {
+public:
+    explicit HnswIndex(int dimension = 3, size_t m = 16, size_t efConstruction = 100);
+
+    // Adds a key, or replaces the stored vector of an existing key (its links are kept)
+    void insert(const std::string& key, const float* vector);
+    bool contains(const std::string& key) const { return nodeOf.count(key) != 0; }
+    void clear();
+
+    // Best k keys by similarity, highest first. Larger ef trades speed for recall.
+    std::vector<std::pair<std::string, float>> search(const std::vector<float>& query, size_t k, size_t ef = 64) const;
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);  // Fails (leaving the index empty) on a missing or mismatched file
+
+    size_t size() const { return keys.size(); }
+    int dimension() const { return dim; }
+
+private:
+    int dim;
+    size_t maxLinks;       // M: links per node on upper layers
+    size_t maxLinksBase;   // 2M: links per node on layer 0
+    size_t efConstruction;
+    double levelScale;
+
+    std::vector<std::string> keys;
+    std::vector<float> vectors;  // Node-major, normalized
+    std::vector<std::vector<std::vector<uint32_t>>> links;  // links[node][layer]
+    std::unordered_map<std::string, uint32_t> nodeOf;
+    int topLayer = -1;
+    uint32_t entryPoint = 0;
+    std::mt19937 rng{20240601};
+
+
+    using Scored = std::pair<float, uint32_t>;  // (similarity, node)
+
+    const float* nodeVector(uint32_t node) const { return vectors.data() + static_cast<size_t>(node) * dim; }
+    float similarity(const float* a, const float* b) const;
+    int randomLayer();
+    uint32_t greedyClosest(const float* query, uint32_t start, int layer) const;
+    std::vector<Scored> searchLayer(const float* query, uint32_t start, size_t ef, int layer) const;  // Best first
+    std::vector<uint32_t> selectNeighbors(const std::vector<Scored>& candidates, size_t limit) const;
+    void shrinkLinks(uint32_t node, int layer);
+};
@@ -0,0 +1,78 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <iosfwd>
+#include <cstdint>
+#include <cstddef>
+
+// Versioned binary model file (trained_model.bin), opened with a read-only
+// memory map so loading costs the same whatever the vocabulary size.
+//
+// Layout (little-endian, offsets from the start of the file):
+//   Header       magic "NOVAMDL1", version, dimension, one SectionHeader
+//                for the word vectors and one for the response embeddings
+//   per section  string offsets (uint64[count + 1]) into the key bytes,
+//                the key bytes, an open-addressing hash table (uint32 row
+//                ids, power-of-two size, FNV-1a) and a float32 matrix of
+//                count x dimension, 64-byte aligned
+//
+// Files are written to a temporary name and renamed over the target, so a
+// reader never sees a half-written model.
+class ModelFile {
+public:
+    enum Section { Words = 0, Responses = 1 };
+
+    static const uint32_t kVersion = 1;
+
+    // In-memory form used for writing and by the text converter
+    struct Data {
+        int dimension = 0;
+        std::vector<std::string> keys[2];  // Indexed by Section
+        std::vector<float> vectors[2];  // keys[s].size() x dimension each
+    };
+
+    ModelFile() = default;
+    ~ModelFile();
+    ModelFile(const ModelFile&) = delete;
+    ModelFile& operator=(const ModelFile&) = delete;
+
+    bool open(const std::string& path);  // Map and validate; false (and closed) on a missing or malformed file
+    void close();
+    bool isOpen() const { return base != nullptr; }
+    const std::string& path() const { return filePath; }
+
+    int dimension() const { return dim; }
+    size_t size(Section section) const { return sections[section].count; }
+    std::string_view key(Section section, size_t row) const;
+    const float* vector(Section section, size_t row) const;
+    const float* find(Section section, std::string_view key) const;  // nullptr if absent
+
+    static bool isModelFile(const std::string& path);  // Checks the magic only
+    static bool save(const std::string& path, const Data& data);  // Atomic replace
+
+    // Debug text form: "nova-model <version> <dimension>", then per section a
+    // "<name> <count>" line and one "<key>\t<values...>" line per row
+    static bool exportText(const ModelFile& model, std::ostream& out);
+    static bool importText(std::istream& in, Data& data);
+
+private:
+    struct SectionView {
+        size_t count = 0;
+        const uint64_t* stringOffsets = nullptr;
+        const char* strings = nullptr;
+        size_t stringsSize = 0;
+        const uint32_t* hash = nullptr;
+        size_t hashSize = 0;
+        const float* matrix = nullptr;
+    };
+
+    std::string filePath;
+    const unsigned char* base = nullptr;
+    size_t mappedSize = 0;
+    void* mappingHandle = nullptr;  // Windows file mapping object
+    int dim = 0;
+    SectionView sections[2];
+
+    static uint64_t hashKey(std::string_view key);
+};
@@ -3,46 +3,146 @@
 
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <cmath>
-#include <sqlite3.h>
 #include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "Database.hpp"
+#include "EmbeddingStore.hpp"
+#include "SimilarityIndex.hpp"
+#include "HnswIndex.hpp"
+#include "Tensor.hpp"
+#include "Embedding.hpp"
+#include "ModelFile.hpp"
+#include "Tokenizer.hpp"
 
+// Settings for trainFromDatabase and trainNetwork
+struct TrainingConfig {
+    enum class Schedule { Constant, StepDecay, Cosine };
+
+    size_t threads = 0;  // Worker threads; 0 = one per hardware thread
+    int epochs = 1;
+    float learningRate = 0.01f;
+
+    // trainNetwork only
+    size_t batchSize = 32;
+    bool shuffle = true;
+    unsigned seed = 42;  // Shuffle order, so runs are reproducible
+    Schedule schedule = Schedule::Constant;
+    float decayFactor = 0.5f;  // StepDecay: multiply the rate by this...
+    int decayEvery = 10;  // ...every this many epochs
+    int patience = 0;  // Stop after this many epochs without improvement; 0 = never
+    float minImprovement = 1e-6f;  // Smaller loss drops don't count as improvement
+
+    float learningRateAt(int epoch) const;  // epoch is 0-based
+};
+
+// Lookups (vectorize, topK) only read the resident
+// tables and may run on several threads at once; training and loading need
+// exclusive access.
 class NeuralNet {
 public:
-    NeuralNet();
-    ~NeuralNet();
+    // Deferred leaves the resident tables empty until loadEmbeddings() and buildIndexes() run
+    enum class WarmUp { Eager, Deferred };
 
+    explicit NeuralNet(std::shared_ptr<DatabasePool> pool = DatabasePool::defaultPool(), WarmUp warmUp = WarmUp::Eager);
+    ~NeuralNet();
 
-    std::unordered_map<std::string, std::vector<float>> wordEmbeddings;     
-    std::vector<float> vectorize(const std::string& input);  // Vectorize input text into word vectors
+    std::vector<float> vectorize(const std::string& input) const;  // Vectorize input text into word vectors
+    template <int N>
+    bool vectorize(std::string_view input, Embedding<N>& out) const;  // No allocation; false unless N == dimension()
+    int dimension() const { return embeddingSize; }
     void reinforce(const std::string& input, const std::string& response);  // Reinforce learning
     void train(const std::string& input, const std::string& response);
-    void ensureTable(sqlite3* db);  // Ensure necessary database tables exist
+    void trainBatch(const std::vector<std::pair<std::string, std::string>>& pairs);  // Quiet pass, one flush at the end
+    void ensureTable(Database& db);  // Ensure necessary database tables exist
     void updateTokenVector(const std::string& token, const std::vector<float>& update);
     std::string generateResponse(const std::string& input);
     
-    void trainFromDatabase(sqlite3* db);
-    void saveModelToFile(const std::string& filename);  // Save model to file
-    void loadModelFromFile(const std::string& filename);  // Load model from file
+    void trainFromDatabase(Database& db, const TrainingConfig& config = TrainingConfig());  // Parallel, see TrainingConfig
+    bool saveModelToFile(const std::string& filename);  // Atomically write word vectors and response embeddings (ModelFile)
+    void loadModelFromFile(const std::string& filename);  // Map the model file; its words back up unknown tokens
     float computeLoss(const std::vector<float>& predicted, const std::vector<float>& actual);
     std::vector<float> forwardPass(const std::vector<float>& input, const std::vector<float>& weights);
     void backpropagate(std::vector<float>& weights, const std::vector<float>& target, float loss, float learningRate);
     void trainNetwork(std::vector<std::vector<float>>& inputs, std::vector<std::vector<float>>& targets, std::vector<float>& weights, float learningRate, int epochs);
-    std::unordered_map<std::string, std::vector<float>> responseEmbeddings;  // Store response embeddings
-    void importModelToDatabase(const std::string& filename);
+    // Fits per-dimension weights so forwardPass(input, weights) approximates target; returns the loss per epoch
+    std::vector<float> trainNetwork(const Tensor& inputs, const Tensor& targets, std::vector<float>& weights, const TrainingConfig& config);
+    std::vector<float> trainOnResponses(Database& db, const TrainingConfig& config, std::vector<float>& weights);  // trainNetwork on topic -> response pairs
+    void importModelToDatabase(const std::string& filename);  // Binary model or legacy text, into an empty word_vectors
+    const ModelFile& modelFile() const { return model; }
+    std::vector<std::pair<std::string, float>> topK(const std::vector<float>& queryVec, size_t k) const;  // Nearest words by cosine
+    void saveAnnIndexes();  // Persist the word HNSW index next to the database
+    void flushTokenVectors();  // Block until queued vector writes have reached the database
+    const Database& database() const { return db; }
+    void loadEmbeddings();  // Copy word_vectors into memory (converting legacy text rows first)
+    void buildIndexes();  // Exact and approximate nearest-neighbour indexes over the loaded tables
+    uint64_t version() const { return modelVersion.load(std::memory_order_relaxed); }  // Moves whenever vectorize/topK may answer differently
 
 private:
-    std::unique_ptr<sqlite3, decltype(&sqlite3_close)> db;  // SQLite database connection
+    std::shared_ptr<DatabasePool> pool;
+    std::string dbPath;
+    Database& db;  // Shared connection from the pool
     void loadPretrainedEmbeddings(const std::string& filename);
     // std::vector<float> getRandomVector();  // Generate a random vector
     void storeTokenVector(const std::string& token, const std::vector<float>& vector);  // Store a token's vector
     std::vector<float> getTokenVector(const std::string& token);  // Retrieve vector for a token
+    const float* lookupToken(std::string_view token, bool logMiss = true) const;  // In-memory lookup, nullptr if unknown
+    const float* lookupWord(const Tokenizer::Token& token, bool logMiss) const;  // Normalized spelling, then the raw one
+    void vectorizeInto(std::string_view input, float* embedding, bool logMisses) const;
+
+    // vectorizeInto runs the Embedding<N> specialization matching the stored vectors, or the generic loop
+    using VectorizeFn = void (NeuralNet::*)(std::string_view, float*, bool) const;
+    VectorizeFn vectorizeImpl = &NeuralNet::vectorizeGeneric;
+    template <int N>
+    void vectorizeFixed(std::string_view input, float* embedding, bool logMisses) const;
+    void vectorizeGeneric(std::string_view input, float* embedding, bool logMisses) const;
+    void setDimension(int dimension);  // Re-specialize; resident tables and indexes start empty
     float cosineSimilarity(const std::vector<float>& vecA, const std::vector<float>& vecB);
-    bool isTableEmpty(sqlite3* db);
+    bool isTableEmpty(Database& db);
+    float trainStep(const std::string& input, const std::string& response);  // One update; returns the loss
     void backpropagate(std::vector<float>& weights, const std::vector<float>& input, const std::vector<float>& target, float learningRate);
-    int embeddingSize = 3;  // Size of token embeddings (can be increased)
+    static const int kDefaultEmbeddingSize = 3;  // Used until word_vectors holds a vector
+    std::atomic<uint64_t> modelVersion{1};
+    void modelChanged() { modelVersion.fetch_add(1, std::memory_order_relaxed); }
+    int embeddingSize;  // Length of the stored word vectors, see EmbeddingStore::detectDimension
+    ModelFile model;  // Mapped by loadModelFromFile
+    void importBinaryModel(const std::string& filename);
+    EmbeddingStore embeddings;  // Resident copy of word_vectors
+    EmbeddingStore pretrained;  // loadPretrainedEmbeddings; checked before `embeddings`
+    SimilarityIndex wordIndex;  // Normalized copy of `embeddings` for nearest-neighbour search
+    void setTokenVector(const std::string& token, const std::vector<float>& vector);  // Updates every copy
+
+    // Approximate word index, used once the vocabulary outgrows exact search
+    static const size_t kAnnThreshold = 20000;
+    HnswIndex wordAnn;
+    bool wordAnnEnabled = false;
+    bool annDirty = false;
+    void loadAnnIndexes();
+    void buildWordAnn();
+
+    // Write-behind persistence for updated token vectors
+    std::unique_ptr<Database> writerDb;  // Pool connection used only by the writer thread
+    std::thread writerThread;
+    std::mutex writerMutex;
+    std::condition_variable writerCv;
+    std::unordered_map<std::string, std::vector<float>> pendingVectors;
+    bool writerBusy = false;
+    bool stopWriter = false;
+    void writerLoop();
+    void writeVectors(const std::unordered_map<std::string, std::vector<float>>& batch);
 };
 
+template <int N>
+bool NeuralNet::vectorize(std::string_view input, Embedding<N>& out) const {
+    if (N != embeddingSize) return false;
+    vectorizeInto(input, out.data(), false);
+    return true;
+}
+
 #endif // NEURALNET_HPP
@@ -0,0 +1,37 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+
+class EmbeddingStore;
+
+// Exact cosine nearest-neighbour search over unit-normalized vectors.
+// Vectors live in a structure-of-arrays matrix (one contiguous column per
+// dimension) so scoring is `dimension` SIMD multiply-adds over all rows.
+// Queries are const and may run on several threads at once.
+class SimilarityIndex {
+public:
+    explicit SimilarityIndex(int dimension = 3);
+
+    void build(const EmbeddingStore& store);  // Row ids match the store's ids
+    void set(uint32_t id, const float* vector);  // Insert or overwrite; normalizes a copy
+    void clear();
+
+    // Raw dot product of `query` (not normalized) with every stored row, indexed by id
+    void score(const std::vector<float>& query, std::vector<float>& out) const;
+
+    // Best k rows by cosine similarity, highest first; ties go to the lower id
+    std::vector<std::pair<uint32_t, float>> topK(const std::vector<float>& query, size_t k) const;
+
+    size_t size() const { return count; }
+    int dimension() const { return dim; }
+
+private:
+    int dim;
+    size_t count = 0;
+    size_t capacity = 0;
+    std::vector<float> columns;  // columns[d * capacity + row]
+
+    void reserve(size_t rows);
+};
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+// Row-major 2-D float buffer. Rows sit back to back, so per-row loops run over
+// contiguous memory instead of chasing one heap block per vector.
+struct Tensor {
+    size_t rows = 0;
+    size_t cols = 0;
+    std::vector<float> data;
+
+    Tensor() = default;
+    Tensor(size_t rows, size_t cols) : rows(rows), cols(cols), data(rows * cols, 0.0f) {}
+
+    float* row(size_t r) { return data.data() + r * cols; }
+    const float* row(size_t r) const { return data.data() + r * cols; }
+};
@@ -0,0 +1,33 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The one tokenizer every component uses, so a word is spelled the same way
+// for embedding lookups, topic extraction and context keywords.
+//
+// Splits on whitespace, folds ASCII to lower case and removes punctuation
+// inside a word ("Don't!" -> "dont"), including the UTF-8 quotes, dashes and
+// ellipsis that show up in the datasets (’ ‘ “ ” – — …). Other non-ASCII
+// characters are kept as they are. Words that are only punctuation are dropped.
+//
+// tokenize() works in one pass over the input and writes the normalized text
+// into a buffer it reuses, so once the buffer has grown it does not allocate.
+class Tokenizer {
+public:
+    struct Token {
+        std::string_view text;  // Normalized, points into the tokenizer's buffer
+        std::string_view source;  // The whitespace-delimited span of the input it came from
+    };
+
+    // Views stay valid until the next tokenize() on this object (and while the input lives)
+    const std::vector<Token>& tokenize(std::string_view input);
+    const std::vector<Token>& tokens() const { return list; }
+
+    static Tokenizer& local();  // Per-thread instance; don't tokenize again while iterating its tokens
+    static std::string normalize(std::string_view word);  // One word, as tokenize() would spell it
+
+private:
+    std::string buffer;
+    std::vector<Token> list;
+};
@@ -13,5 +13,4 @@ public:
 private:
     static const std::unordered_set<std::string> stopwords;
     static std::map<std::string, std::string> phraseToTopicMap;
-    static std::string clean(const std::string& word);
 };
@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <sqlite3.h>
+
+// Versioned binary encoding for the word_vectors.vector BLOB column.
+//
+// Layout (little-endian):
+//   bytes 0-1  magic "NV"
+//   byte  2    format version
+//   byte  3    encoding (see Encoding)
+//   bytes 4-5  dimension
+//   bytes 6-7  reserved
+//   Int8 only: float32 scale, then the quantized values
+//   otherwise: the values as float32 or float16
+//
+// Rows written before this format existed hold space- or comma-separated
+// decimal text; decode() still accepts those.
+class VectorCodec {
+public:
+    enum class Encoding : uint8_t { Float32 = 0, Float16 = 1, Int8 = 2 };
+
+    static const uint8_t kVersion = 1;
+    static const size_t kHeaderSize = 8;
+
+    static std::vector<unsigned char> encode(const std::vector<float>& values, Encoding encoding = Encoding::Float32);
+    static bool decode(const void* data, size_t size, std::vector<float>& out);  // Binary or legacy text
+    static bool isBinary(const void* data, size_t size);
+
+    // Read column `col` of the current row, whatever its storage class
+    static bool readColumn(sqlite3_stmt* stmt, int col, std::vector<float>& out);
+    static void bindVector(sqlite3_stmt* stmt, int index, const std::vector<float>& values,
+                           Encoding encoding = Encoding::Float32);
+
+    // One-shot conversion of legacy text rows in word_vectors; returns rows converted
+    static int migrateTextRows(sqlite3* db, Encoding encoding = Encoding::Float32);
+
+private:
+    static uint16_t floatToHalf(float value);
+    static float halfToFloat(uint16_t half);
+    static bool parseText(const char* text, size_t size, std::vector<float>& out);
+};
@@ -0,0 +1,22 @@
+#pragma once
+#include <cstddef>
+
+// Float vector kernels shared by the similarity, loss and training code.
+// The implementation is picked once at runtime from what the CPU supports:
+// AVX2+FMA, SSE4.1, or plain scalar code (also used off x86).
+class VectorMath {
+public:
+    enum class Isa { Scalar, SSE4, AVX2 };
+
+    static float dot(const float* a, const float* b, size_t n);
+    static float norm(const float* a, size_t n);
+    static float cosine(const float* a, const float* b, size_t n);  // 0 if either vector is zero
+    static void axpy(float alpha, const float* x, float* y, size_t n);  // y += alpha * x
+    static void mul(const float* a, const float* b, float* out, size_t n);  // out = a * b, element-wise
+    static float mse(const float* a, const float* b, size_t n);  // Mean of (a - b)^2
+
+    static Isa isa();  // Currently selected implementation
+    static bool supports(Isa isa);
+    static bool setIsa(Isa isa);  // Force an implementation (benchmarks); false if unsupported
+    static const char* name(Isa isa);
+};
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+// Process-wide symbol table. A token gets a dense 32-bit id the first time it
+// is interned and keeps it until the process exits, so tables keyed by token
+// (EmbeddingStore rows, context scores) hold ids and index flat arrays instead
+// of hashing and copying strings.
+//
+// find() and word() take no lock and may run while another thread interns;
+// intern() serializes writers on a mutex. Ids and their strings are never
+// freed or moved, so the vocabulary only grows.
+class Vocabulary {
+public:
+    using Id = uint32_t;
+    static constexpr Id kNone = UINT32_MAX;
+
+    static Vocabulary& global();
+
+    Vocabulary();
+    ~Vocabulary();
+    Vocabulary(const Vocabulary&) = delete;
+    Vocabulary& operator=(const Vocabulary&) = delete;
+
+    Id intern(std::string_view word);  // The word's id, assigning the next one if it is new
+    Id find(std::string_view word) const;  // kNone if the word was never interned
+    std::string_view word(Id id) const;  // id must come from intern() or find()
+    size_t size() const { return count.load(std::memory_order_acquire); }
+    size_t memoryUsage() const;  // Bytes held by records, segments and hash tables
+
+private:
+    // Each word is stored as a Header followed by its bytes; an id maps to that record
+    struct Header {
+        uint32_t hash;  // Low bits of the full hash, compared before the bytes
+        uint32_t length;
+    };
+
+    // Open addressing, linear probing; a slot holds id + 1, or 0 when empty
+    struct Table {
+        size_t mask;
+        std::unique_ptr<std::atomic<uint32_t>[]> slots;
+    };
+
+    // Entries live in segments that double in size, so growing never moves one
+    static const size_t kFirstSegment = 1024;
+    static const int kSegments = 23;  // Enough for every 32-bit id
+    std::atomic<const char**> segments[kSegments] = {};
+    const char* record(Id id) const;
+
+    std::atomic<Table*> table{nullptr};
+    std::atomic<size_t> count{0};
+
+    // Writer-only state. Replaced tables stay alive for readers that still hold them.
+    mutable std::mutex writeMutex;
+    std::vector<std::unique_ptr<Table>> tables;
+    std::vector<std::unique_ptr<char[]>> blocks;  // Record storage
+    char* block = nullptr;  // The block short records are appended to
+    size_t blockUsed = 0;
+    size_t blockBytes = 0;  // Total size of `blocks`
+
+    const char* store(std::string_view word, uint32_t hash);
+    void rehash(size_t slots);
+    static void place(Table& target, size_t hash, Id id);
+};
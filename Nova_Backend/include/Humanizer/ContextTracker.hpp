@@ -1,32 +1,59 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <deque>
-#include <map>
 #include <set>
 #include <vector>
-#include <sstream>
+#include <array>
+#include <utility>
 
+// Per-conversation context: the last few messages and decaying topic scores.
+// Both live in fixed-size storage allocated with the tracker, so a session's
+// context takes the same memory after ten turns as after a million.
 class ContextTracker {
 public:
     ContextTracker();
 
-    void addMessage(const std::string& message);
-    std::deque<std::string> getRecentMessages(size_t count = 5) const;
+    void addMessage(const std::string& message);  // One turn; older topic scores decay
+    std::deque<std::string> getRecentMessages(size_t count = 5) const;  // Newest first
     std::string getRecentContext() const;
     std::string summarizeContext() const;
     bool topicExists(const std::string& topic) const;
     void boostTopicRelevance(const std::string& topic, int amount);
     void boostTopicRelevanceByKeywords(const std::string& message);
+    float topicScore(const std::string& topic) const;  // Decayed; 0 if not tracked
+    std::vector<std::pair<std::string_view, float>> topTopics(size_t count) const;  // Highest first; valid until the next boost
 
     std::set<std::string> extractKeywords(const std::string& message) const; // Extract keywords
     std::vector<std::string> getRelevantContext() const; // Get weighted context
-    void clearContext() {
-        contextMessages.clear();
-    }
+    void clearContext();
+
+    static constexpr size_t MAX_CONTEXT_SIZE = 5;
+    static constexpr size_t MAX_MESSAGE_BYTES = 512;  // Longer messages keep their first 512 bytes
+    static constexpr size_t MAX_TOPICS = 32;  // The lowest score makes room for a new topic
+    static constexpr size_t MAX_TOPIC_BYTES = 32;  // Longer topics are tracked by their first 32 bytes
+    static constexpr int TOPIC_HALF_LIFE = 8;  // Turns for a score to halve
+
 private:
-    std::vector<std::string> contextMessages;
+    // Ring buffer; each slot reserves MAX_MESSAGE_BYTES up front
+    std::array<std::string, MAX_CONTEXT_SIZE> messages;
+    size_t newest = MAX_CONTEXT_SIZE - 1;
+    size_t messageCount = 0;
+    const std::string& message(size_t age) const;  // 0 = newest
     void addToContext(const std::string& message);
-    std::deque<std::string> contextDeque;
-    std::map<std::string, int> topicRelevance;
-    static const size_t MAX_CONTEXT_SIZE = 5;
+
+    // Scores decay lazily: a boost adds amount * scale, scale grows every turn and
+    // the real score is weight / scale. Sorted by weight, highest first, which is
+    // the decayed order too, since every weight shares the same scale.
+    // Topics are kept here rather than interned in the shared Vocabulary, which
+    // never frees a word: user input must not grow memory beyond the session.
+    struct TopicScore {
+        std::string topic;  // Reserves MAX_TOPIC_BYTES up front
+        double weight;
+    };
+    std::array<TopicScore, MAX_TOPICS> topics;
+    size_t topicCount = 0;
+    double scale = 1.0;
+    void boost(std::string_view topic, int amount);
+    const TopicScore* findTopic(std::string_view topic) const;
 };
@@ -0,0 +1,85 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <cstdint>
+#include "TopicIndex.hpp"
+
+// Bounded LRU cache in front of ResponseVariator's exact -> fuzzy -> NN chain,
+// keyed by the normalized input (TopicIndex::normalize). An entry keeps the
+// matched topic's most confident candidates, so a hit still picks among equally
+// confident replies with the conversation's RNG. Inputs no topic matches are
+// cached too, which skips the fuzzy search, and can carry the NN's answer.
+//
+// The cache is split into shards with a mutex each, so sessions on different
+// threads rarely wait on one another. Entries leave when their topic gains a
+// response or feedback, when a new topic could now fuzzy-match their input, or
+// by eviction; NN answers also expire when NeuralNet::version() moves.
+class ResponseCache {
+public:
+    struct Entry {
+        std::string topic;  // Topic the input matched, exactly or fuzzily; empty if none did
+        std::vector<ResponseCandidate> candidates;  // That topic's most confident candidates when cached
+        std::string generated;  // NN answer, for entries without a topic
+        std::string generatedFor;  // The raw input it answered; NN lookups fall back to raw spellings
+        uint64_t modelVersion = 0;  // NeuralNet::version() it was computed at; 0 = none yet
+    };
+
+    struct Stats {
+        uint64_t hits = 0;  // Lookups that found an entry
+        uint64_t misses = 0;
+        uint64_t generatedHits = 0;  // NN answers reused
+        uint64_t generatedMisses = 0;  // NN answers computed (none cached, or the model moved)
+        uint64_t evictions = 0;
+        uint64_t invalidations = 0;  // Entries dropped by teaching or feedback
+        size_t entries = 0;
+        size_t capacity = 0;
+        size_t bytes = 0;  // Approximate heap held by entries, keys and the indexes over them
+        double hitRate() const { return hits + misses ? static_cast<double>(hits) / (hits + misses) : 0.0; }
+    };
+
+    explicit ResponseCache(size_t capacity = 4096);
+
+    std::shared_ptr<const Entry> find(const std::string& key);  // Counts a hit or a miss; marks the entry recent
+    void insert(const std::string& key, Entry entry);  // Replaces an existing entry
+    std::string findGenerated(const std::string& key, const std::string& input, uint64_t modelVersion);  // Empty if not cached
+    void setGenerated(const std::string& key, const std::string& input, const std::string& generated, uint64_t modelVersion);  // Only while key is cached
+
+    // Topics are normalized. `changed` topics drop the entries that matched them;
+    // `added` (new) topics also drop entries whose key is within fuzzy range
+    void invalidate(const std::vector<std::string>& changed, const std::vector<std::string>& added = {});
+    void clear();
+    Stats stats() const;
+
+    static const int kFuzzyDistance = 2;  // Same range as ResponseVariator::findSimilarWord
+
+private:
+    struct Node {
+        std::string key;
+        std::shared_ptr<const Entry> entry;
+        size_t bytes;
+    };
+    using NodeList = std::list<Node>;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        NodeList lru;  // Most recently used first
+        std::unordered_map<std::string_view, NodeList::iterator> byKey;  // Views into Node::key
+        std::unordered_map<std::string, std::vector<NodeList::iterator>> byTopic;
+        size_t bytes = 0;
+        uint64_t hits = 0, misses = 0, generatedHits = 0, generatedMisses = 0, evictions = 0, invalidations = 0;
+    };
+
+    static const size_t kShards = 16;
+    size_t shardCapacity;
+    std::unique_ptr<Shard[]> shards;
+
+    Shard& shardFor(const std::string& key) const;
+    static void erase(Shard& shard, NodeList::iterator node);  // Caller holds shard.mutex
+    void put(Shard& shard, const std::string& key, std::shared_ptr<const Entry> entry);
+    static size_t footprint(const std::string& key, const Entry& entry);
+};
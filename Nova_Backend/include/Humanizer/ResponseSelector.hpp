@@ -1,18 +1,39 @@
 #pragma once
 #include "../Core/NeuralNet.hpp"
+#include "../Core/SimilarityIndex.hpp"
+#include "../Core/Database.hpp"
 #include <string>
 #include <vector>
 #include <tuple>
-#include <sqlite3.h>
+#include <unordered_map>
 
 class ResponseSelector {
 public:
-    ResponseSelector(const std::string& dbPath);
+    explicit ResponseSelector(std::shared_ptr<DatabasePool> pool = DatabasePool::defaultPool());
+    ~ResponseSelector();
 
     std::string chooseBest(const std::string& input);
+    void addResponse(const std::string& topic, const std::string& response, float confidence = 0.5f, const std::string& tag = "");
+    void flushUsage();  // Write pending use_count/last_used updates
 
 private:
+    struct Row {
+        int id;
+        std::string response;
+        float confidence;
+    };
+
     void initializeDB();
+    void loadRows();  // Cache rows and their topic vectors, computing any that are missing
+    std::shared_ptr<DatabasePool> pool;
     NeuralNet nn;
-    sqlite3* db;
-};
\ No newline at end of file
+    Database& db;
+
+    std::vector<Row> rows;
+    SimilarityIndex topicVectors;  // Row i's topic embedding, scored in one batched pass
+    std::vector<float> scores;  // Scratch buffer for chooseBest
+
+    // Usage stats are batched: id -> (times used, last used timestamp)
+    std::unordered_map<int, std::pair<int, int>> pendingUsage;
+    static const size_t kUsageBatch = 32;
+};
@@ -7,28 +7,64 @@
 #include <queue>
 #include <deque>
 #include <random>
-#include <sqlite3.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 #include "../Core/NeuralNet.hpp"
+#include "../Core/Database.hpp"
 #include "../Core/WordVectorHelper.hpp"
 #include "../Core/TopicExtractor.hpp"
 #include "../Humanizer/ContextTracker.hpp"
+#include "../Humanizer/TopicIndex.hpp"
+#include "../Humanizer/ResponseCache.hpp"
 
 class ResponseVariator {
 public:
-    ResponseVariator();
+    explicit ResponseVariator(std::shared_ptr<DatabasePool> pool = DatabasePool::defaultPool(),
+                              NeuralNet::WarmUp warmUp = NeuralNet::WarmUp::Eager);
+    ~ResponseVariator();  // Flushes queued feedback
 
     void trainFromDatabaseOnce();  // Train from the database once
     void trainFromDatabaseForDev();  // Train for dev (when the database has grown large)
     void saveModel() {
-        neuralNet.saveModelToFile("trained_model.txt");  // Save model
+        neuralNet.saveModelToFile("trained_model.bin");  // Save model
     }
     void loadModel() {
-        neuralNet.loadModelFromFile("trained_model.txt");  // Load model
+        neuralNet.loadModelFromFile("trained_model.bin");  // Load model
     }
 
-    std::string getResponse(const std::string& input);
+    // State of one conversation. Answering only reads the shared tables, so
+    // several conversations can be answered at once (ChatBotController sessions)
+    struct Conversation {
+        std::default_random_engine rng{std::random_device{}()};  // Breaks confidence ties
+        ContextTracker context;
+        std::string lastTopic;
+        int turnCount = 0;
+    };
+
+    std::string getResponse(const std::string& input);  // Uses the built-in conversation
+    std::string getResponse(const std::string& input, Conversation& conversation);
+    std::string getIndexedResponse(const std::string& input, Conversation& conversation);  // Exact or fuzzy topic match only; empty if none
+    std::string getGeneratedResponse(const std::string& input) const;  // NN stage, or the "don't know" fallback
+    void recordTurn(Conversation& conversation, const std::string& input) const;
     void addResponse(const std::string& input, const std::string& response);
-    void updateConfidenceInDatabase(const std::string& input, const std::string& response, bool positive);
+    void updateConfidenceInDatabase(const std::string& input, const std::string& response, bool positive);  // Write-behind
+
+    // Feedback deltas update the topic index at once and coalesce per (topic, response);
+    // a background thread writes them in one transaction per batch
+    struct FeedbackStats {
+        size_t queued = 0;  // Distinct (topic, response) keys waiting to be written
+        uint64_t received = 0;  // Feedback calls
+        uint64_t coalesced = 0;  // Calls merged into a key that was already queued
+        uint64_t flushes = 0;
+        uint64_t rowsWritten = 0;
+        double lastFlushMs = 0.0;
+        double maxFlushMs = 0.0;
+        double totalFlushMs = 0.0;
+    };
+    FeedbackStats getFeedbackStats() const;
+    void flushFeedback();  // Block until queued feedback has reached the database
     std::string getFallbackResponse() const;
     void startTeachingMode();
     void stopTeachingMode();
@@ -36,33 +72,54 @@ public:
     std::vector<std::string> extractTopics(const std::string& input);
     void teachAlternative(const std::string& topic, const std::string& altResponse);
     std::string getFollowupSuggestion();
-    void bulkTeachFromCSV(const std::string& filepath);
+    void bulkTeachFromCSV(const std::string& filepath);  // intent,text,response,weight or topic,response,score
     std::unordered_map<std::string, std::pair<std::string, double>> knowledgeBase;
     NeuralNet neuralNet;
-    void saveResponse(const std::string& input, const std::string& response, float confidence);
+    bool saveResponse(const std::string& input, const std::string& response, float confidence);
     double getConfidenceForResponse(const std::string& input, const std::string& response);
+    TopicIndex::Stats getTopicIndexStats() const;  // Exact-match index hit/miss counters
+    ResponseCache::Stats getResponseCacheStats() const;
+    void clearResponseCache();  // After editing the responses table behind this object's back
+    const Database& database() const { return db; }
 
 private:
     std::string findSimilarWord(const std::string& input);
     int levenshteinDistance(const std::string& a, const std::string& b);
     void loadDatabase();
     void createTablesIfNotExist();
-    int turnCount = 0; 
     std::string lastUsedResponse;
-    sqlite3* db = nullptr;
-    std::map<std::string, std::set<std::string>> topicMap;
+    std::shared_ptr<DatabasePool> pool;
+    Database& db;  // Same connection neuralNet uses
+    TopicIndex topicIndex;
+    mutable ResponseCache responseCache;  // In front of getIndexedResponse and getGeneratedResponse
+    bool insertResponse(const std::string& topic, const std::string& response, float confidence);  // Database row only; no index or cache update
+    static const size_t kImportBatch = 10000;  // Rows per transaction in bulkTeachFromCSV
+
+    // Write-behind confidence feedback, see updateConfidenceInDatabase
+    static constexpr std::chrono::milliseconds kFeedbackInterval{250};  // Gathers clicks into one transaction
+    std::unique_ptr<Database> feedbackDb;  // Pool connection used only by the feedback thread
+    std::thread feedbackThread;
+    mutable std::mutex feedbackMutex;
+    std::condition_variable feedbackCv;
+    std::map<std::pair<std::string, std::string>, double> pendingFeedback;  // (topic, response) -> delta
+    FeedbackStats feedbackStats;
+    bool feedbackBusy = false;
+    bool flushRequested = false;
+    bool stopFeedback = false;
+    void feedbackLoop();
+    void writeFeedback(const std::map<std::pair<std::string, std::string>, double>& batch);
+    static std::string pickCandidate(const std::vector<ResponseCandidate>& candidates, std::default_random_engine& rng);
+    static std::vector<ResponseCandidate> topCandidates(const std::vector<ResponseCandidate>& candidates);
     std::set<std::string> askedQuestions;
     std::deque<std::string> contextMemory;
-    std::default_random_engine rng;
     bool teachingMode = false;
     std::string fallbackResponse = "I don't know yet.";
-    std::string lastTopic;
-    ContextTracker contextTracker;
+    Conversation conversation;  // For callers that don't track their own
 
     void addToContext(const std::string& message);
     std::string summarizeContext() const;
     std::string lastFollowup = "";
-    std::string generateResponseFromNN(const std::string& input);
+    std::string generateResponseFromNN(const std::string& input) const;
     float cosineSimilarity(const std::vector<float>& vec1, const std::vector<float>& vec2);
 
 };
\ No newline at end of file
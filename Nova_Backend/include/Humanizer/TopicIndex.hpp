@@ -0,0 +1,46 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <atomic>
+#include <sqlite3.h>
+#include "../Core/BKTree.hpp"
+
+// A single stored reply for a topic
+struct ResponseCandidate {
+    std::string response;
+    float confidence;
+    std::string topic;  // As spelled in the responses row; the index key is normalized
+};
+
+// Resident topic -> candidates index mirroring the `responses` table,
+// so exact-match lookups never touch SQLite. Lookups may run on several
+// threads at once; add() and adjustConfidence() need exclusive access.
+class TopicIndex {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t topics = 0;
+        size_t candidates = 0;
+    };
+
+    void load(sqlite3* db);  // Build the index from the responses table
+    const std::vector<ResponseCandidate>* find(const std::string& topic) const;  // Counts hits/misses
+    bool add(const std::string& topic, const std::string& response, float confidence);  // True for a new topic
+    // Returns the stored topic spellings it changed, so the same rows can be updated in the database
+    std::vector<std::string> adjustConfidence(const std::string& topic, const std::string& response, float delta);
+    std::string findSimilar(const std::string& topic, int maxDistance) const;  // Empty if none within range
+    bool confidenceOf(const std::string& topic, const std::string& response, float& out) const;
+    Stats stats() const;
+
+    static std::string normalize(const std::string& topic);
+
+private:
+    std::unordered_map<std::string, std::vector<ResponseCandidate>> index;
+    BKTree fuzzyIndex;  // Distinct normalized topics, for edit-distance lookups
+    size_t candidateCount = 0;
+    mutable std::atomic<uint64_t> hits{0};
+    mutable std::atomic<uint64_t> misses{0};
+};
@@ -1,21 +1,159 @@
 #include "../include/Controller.hpp"
 #include <iostream>
 
-ChatBotController::ChatBotController() {
+// Only the topic index is loaded here; initialize() starts the rest
+ChatBotController::ChatBotController(std::shared_ptr<DatabasePool> pool) : bot(std::move(pool), NeuralNet::WarmUp::Deferred) {
     std::cout << "[BOOT] ChatBotController constructor called" << std::endl;
+    sessions[kDefaultSession] = std::make_shared<Session>();
+    worker = std::thread(&ChatBotController::workerLoop, this);
 }
-ChatBotController::~ChatBotController() {}
 
-void ChatBotController::initialize(const std::string& modelFile) {
-    std::cout << "[Controller] Loading model from: " << modelFile << std::endl;
-    neuralNet.loadModelFromFile(modelFile);
-    neuralNet.importModelToDatabase(modelFile);
+// Pending requests are cancelled; posted feedback and teaching still run
+ChatBotController::~ChatBotController() {
+    std::vector<Job> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        stopWorker = true;
+        cancelled = takeRequests(nextRequestId);
+        if (runningId != 0) runningCancelled = true;
+    }
+    jobCv.notify_all();
+    deliverCancelled(cancelled);
+    if (worker.joinable()) worker.join();
+    if (startupThread.joinable()) startupThread.join();
+}
+
+void ChatBotController::initialize(const std::string& modelFile, StartupCallback onProgress) {
+    std::lock_guard<std::mutex> lock(startupMutex);
+    if (status.stage != StartupStage::NotStarted) {
+        std::cout << "[Controller] Startup already running or done; ignoring initialize(" << modelFile << ")" << std::endl;
+        return;
+    }
+
+    std::cout << "[Controller] Loading model from: " << modelFile << " (in the background)" << std::endl;
+    startupCallback = std::move(onProgress);
+    startupBegan = std::chrono::steady_clock::now();
+    status.stage = StartupStage::LoadingEmbeddings;
+    startupThread = std::thread(&ChatBotController::runStartup, this, modelFile);
+}
+
+void ChatBotController::runStartup(const std::string& modelFile) {
+    setStage(StartupStage::LoadingEmbeddings);
+    bot.neuralNet.loadEmbeddings();
+    setStage(StartupStage::BuildingIndexes);
+    bot.neuralNet.buildIndexes();
+
+    if (!modelFile.empty()) {
+        setStage(StartupStage::LoadingModel);
+        bot.neuralNet.loadModelFromFile(modelFile);
+        setStage(StartupStage::ImportingModel);
+        bot.neuralNet.importModelToDatabase(modelFile);
+    }
+    setStage(StartupStage::Ready);
+}
+
+void ChatBotController::setStage(StartupStage stage) {
+    StartupStatus snapshot;
+    StartupCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(startupMutex);
+        const float stages = static_cast<float>(StartupStage::Ready) - static_cast<float>(StartupStage::LoadingEmbeddings);
+        status.stage = stage;
+        status.progress = (static_cast<float>(stage) - static_cast<float>(StartupStage::LoadingEmbeddings)) / stages;
+        status.elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startupBegan).count();
+        snapshot = status;
+        callback = startupCallback;
+    }
+    if (stage == StartupStage::Ready) startupCv.notify_all();
+
+    std::cout << "[Controller] Startup: " << stageName(stage) << " at " << snapshot.elapsedMs << " ms" << std::endl;
+    if (callback) callback(snapshot);
+}
+
+ChatBotController::StartupStatus ChatBotController::startupStatus() const {
+    std::lock_guard<std::mutex> lock(startupMutex);
+    return status;
+}
+
+bool ChatBotController::isReady() const {
+    std::lock_guard<std::mutex> lock(startupMutex);
+    return status.stage == StartupStage::Ready;
+}
+
+void ChatBotController::waitUntilReady() {
+    std::unique_lock<std::mutex> lock(startupMutex);
+    if (status.stage == StartupStage::NotStarted) {
+        // No initialize(): warm up on this thread, without a model file
+        status.stage = StartupStage::LoadingEmbeddings;
+        startupBegan = std::chrono::steady_clock::now();
+        lock.unlock();
+        runStartup("");
+        return;
+    }
+    startupCv.wait(lock, [this] { return status.stage == StartupStage::Ready; });
+}
+
+const char* ChatBotController::stageName(StartupStage stage) {
+    switch (stage) {
+        case StartupStage::NotStarted: return "not started";
+        case StartupStage::LoadingEmbeddings: return "loading word vectors";
+        case StartupStage::BuildingIndexes: return "building search indexes";
+        case StartupStage::LoadingModel: return "mapping model file";
+        case StartupStage::ImportingModel: return "importing model";
+        case StartupStage::Ready: return "ready";
+    }
+    return "unknown";
+}
+
+ChatBotController::SessionId ChatBotController::openSession() {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    SessionId id = nextSessionId++;
+    sessions[id] = std::make_shared<Session>();
+    return id;
+}
+
+void ChatBotController::closeSession(SessionId session) {
+    if (session == kDefaultSession) return;
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    sessions.erase(session);  // A turn still running keeps its Session alive
+}
+
+size_t ChatBotController::sessionCount() const {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    return sessions.size();
+}
+
+std::shared_ptr<ChatBotController::Session> ChatBotController::findSession(SessionId session) const {
+    std::lock_guard<std::mutex> lock(sessionMutex);
+    auto it = sessions.find(session);
+    return it != sessions.end() ? it->second : nullptr;
 }
 
 std::string ChatBotController::getChatbotResponse(const std::string& input) {
+    return getChatbotResponse(kDefaultSession, input);
+}
+
+std::string ChatBotController::getChatbotResponse(SessionId sessionId, const std::string& input) {
+    auto session = findSession(sessionId);
+    if (!session) {
+        std::cerr << "[Controller] Unknown session " << sessionId << std::endl;
+        return "";
+    }
+    std::lock_guard<std::mutex> turn(session->turnMutex);
     std::cout << "[Controller] Received input: " << input << std::endl;
 
-    std::string response = bot.getResponse(input);
+    // Exact and fuzzy matches are served straight away; the NN stage waits for startup
+    std::string response;
+    {
+        std::shared_lock<std::shared_mutex> read(botMutex);
+        response = bot.getIndexedResponse(input, session->conversation);
+    }
+    if (response.empty()) {
+        waitUntilReady();
+        std::shared_lock<std::shared_mutex> read(botMutex);
+        response = bot.getGeneratedResponse(input);
+    }
+    bot.recordTurn(session->conversation, input);
     std::cout << "[Controller] Response from bot: " << response << std::endl;
 
     if (response.empty() || response == input) {
@@ -27,6 +165,8 @@ std::string ChatBotController::getChatbotResponse(const std::string& input) {
 }
 
 void ChatBotController::provideFeedback(const std::string& input, const std::string& response, bool positive) {
+    waitUntilReady();
+    std::unique_lock<std::shared_mutex> write(botMutex);
     bot.updateConfidenceInDatabase(input, response, positive);
 }
 
@@ -37,6 +177,8 @@ void ChatBotController::teachMode(const std::string& input) {
         return;
     }
 
+    waitUntilReady();
+    std::unique_lock<std::shared_mutex> write(botMutex);
     std::string topic = input.substr(0, eq);
     std::string response = input.substr(eq + 1);
     bot.addResponse(topic, response);
@@ -45,5 +187,146 @@ void ChatBotController::teachMode(const std::string& input) {
 
 double ChatBotController::getConfidenceScore(const std::string& input, const std::string& response)
 {
+    waitUntilReady();
+    std::shared_lock<std::shared_mutex> read(botMutex);
     return bot.getConfidenceForResponse(input, response);
 }
+
+ResponseCache::Stats ChatBotController::getResponseCacheStats() const
+{
+    return bot.getResponseCacheStats();
+}
+
+uint64_t ChatBotController::submitRequest(const std::string& input, ReplyCallback onReply, bool supersede) {
+    Job job;
+    job.input = input;
+    job.onReply = std::move(onReply);
+    job.submitted = std::chrono::steady_clock::now();
+
+    uint64_t id;
+    std::vector<Job> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        id = job.id = nextRequestId++;
+        if (supersede) {
+            cancelled = takeRequests(id);
+            if (runningId != 0) runningCancelled = true;
+        }
+        jobs.push_back(std::move(job));
+    }
+    jobCv.notify_one();
+    deliverCancelled(cancelled);
+    return id;
+}
+
+std::future<ChatBotController::Reply> ChatBotController::requestResponse(const std::string& input, bool supersede) {
+    auto promise = std::make_shared<std::promise<Reply>>();
+    std::future<Reply> reply = promise->get_future();
+    submitRequest(input, [promise](const Reply& r) { promise->set_value(r); }, supersede);
+    return reply;
+}
+
+bool ChatBotController::cancelRequest(uint64_t id) {
+    std::vector<Job> cancelled;
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        if (runningId == id && id != 0) {
+            runningCancelled = true;  // Still computed, but delivered as cancelled
+            return true;
+        }
+        for (auto it = jobs.begin(); it != jobs.end(); ++it) {
+            if (it->id == id && id != 0) {
+                cancelled.push_back(std::move(*it));
+                jobs.erase(it);
+                break;
+            }
+        }
+    }
+    deliverCancelled(cancelled);
+    return !cancelled.empty();
+}
+
+void ChatBotController::submitFeedback(const std::string& input, const std::string& response, bool positive) {
+    Job job;
+    job.action = [this, input, response, positive] { provideFeedback(input, response, positive); };
+    post(std::move(job));
+}
+
+void ChatBotController::submitTeach(const std::string& input) {
+    Job job;
+    job.action = [this, input] { teachMode(input); };
+    post(std::move(job));
+}
+
+void ChatBotController::post(Job job) {
+    job.submitted = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(jobMutex);
+        jobs.push_back(std::move(job));
+    }
+    jobCv.notify_one();
+}
+
+std::vector<ChatBotController::Job> ChatBotController::takeRequests(uint64_t olderThan) {
+    std::vector<Job> taken;
+    for (auto it = jobs.begin(); it != jobs.end();) {
+        if (it->id != 0 && it->id < olderThan) {
+            taken.push_back(std::move(*it));
+            it = jobs.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    return taken;
+}
+
+void ChatBotController::deliverCancelled(std::vector<Job>& cancelled) {
+    auto now = std::chrono::steady_clock::now();
+    for (auto& job : cancelled) {
+        Reply reply;
+        reply.id = job.id;
+        reply.input = job.input;
+        reply.cancelled = true;
+        reply.queuedMs = reply.latencyMs = std::chrono::duration<double, std::milli>(now - job.submitted).count();
+        if (job.onReply) job.onReply(reply);
+    }
+}
+
+void ChatBotController::workerLoop() {
+    std::unique_lock<std::mutex> lock(jobMutex);
+    while (true) {
+        jobCv.wait(lock, [this] { return stopWorker || !jobs.empty(); });
+        if (jobs.empty()) break;  // Stopping with nothing left to run
+
+        Job job = std::move(jobs.front());
+        jobs.pop_front();
+        runningId = job.id;
+        runningCancelled = false;
+        lock.unlock();
+
+        if (job.action) {
+            job.action();
+            lock.lock();
+            continue;
+        }
+
+        auto started = std::chrono::steady_clock::now();
+        std::string response = getChatbotResponse(job.input);
+
+        lock.lock();
+        Reply reply;
+        reply.id = job.id;
+        reply.input = job.input;
+        reply.cancelled = runningCancelled;
+        runningId = 0;
+        lock.unlock();
+
+        if (!reply.cancelled) reply.response = std::move(response);
+        auto finished = std::chrono::steady_clock::now();
+        reply.queuedMs = std::chrono::duration<double, std::milli>(started - job.submitted).count();
+        reply.latencyMs = std::chrono::duration<double, std::milli>(finished - job.submitted).count();
+        if (job.onReply) job.onReply(reply);
+        lock.lock();
+    }
+}
+
@@ -0,0 +1,83 @@
+#include "../../include/Core/BKTree.hpp"
+#include "../../include/Core/EditDistance.hpp"
+#include <algorithm>
+
+int BKTree::distance(const std::string& a, const std::string& b) {
+    return EditDistance::levenshtein(a, b);
+}
+
+void BKTree::insert(const std::string& word) {
+    if (nodes.empty()) {
+        nodes.push_back({word, {}});
+        return;
+    }
+
+    uint32_t current = 0;
+    while (true) {
+        int d = distance(word, nodes[current].word);
+        if (d == 0) return;  // Already present
+
+        auto& children = nodes[current].children;
+        auto it = std::find_if(children.begin(), children.end(),
+                               [d](const auto& edge) { return edge.first == d; });
+        if (it == children.end()) {
+            children.emplace_back(d, static_cast<uint32_t>(nodes.size()));
+            nodes.push_back({word, {}});
+            return;
+        }
+        current = it->second;
+    }
+}
+
+void BKTree::clear() {
+    nodes.clear();
+}
+
+bool BKTree::findClosest(const std::string& query, int maxDistance, std::string& out,
+                         int* distanceOut, size_t* visited) const {
+    if (nodes.empty()) return false;
+
+    int bestDistance = maxDistance + 1;
+    uint32_t bestNode = 0;
+    size_t computed = 0;
+
+    std::vector<uint32_t> pending{0};
+    while (!pending.empty()) {
+        uint32_t index = pending.back();
+        pending.pop_back();
+
+        const Node& node = nodes[index];
+
+        // Distances beyond the largest child edge plus the tolerance can't
+        // match this node or any child, so the kernel may stop early there
+        int tolerance = std::min(bestDistance, maxDistance);
+        int maxEdge = 0;
+        for (const auto& edge : node.children) maxEdge = std::max(maxEdge, edge.first);
+        int limit = maxEdge + tolerance;
+
+        int d = EditDistance::bounded(query, node.word, limit);
+        ++computed;
+        if (d > limit) continue;
+
+        if (d < bestDistance || (d == bestDistance && index < bestNode)) {
+            bestDistance = d;
+            bestNode = index;
+        }
+
+        // Only children whose edge lies within [d - tol, d + tol] can hold a
+        // word at distance <= tol; keep ties reachable for insertion-order wins
+        tolerance = std::min(bestDistance, maxDistance);
+        for (const auto& [edge, child] : node.children) {
+            if (edge >= d - tolerance && edge <= d + tolerance) {
+                pending.push_back(child);
+            }
+        }
+    }
+
+    if (visited) *visited = computed;
+    if (bestDistance > maxDistance) return false;
+
+    out = nodes[bestNode].word;
+    if (distanceOut) *distanceOut = bestDistance;
+    return true;
+}
@@ -0,0 +1,59 @@
+#include "../../include/Core/CsvReader.hpp"
+
+CsvReader::CsvReader(std::istream& in) : buffer(in.rdbuf()) {
+    // Skip a UTF-8 byte order mark written by spreadsheet exports
+    if (buffer && buffer->sgetc() == 0xEF) {
+        buffer->sbumpc();
+        if (buffer->sgetc() == 0xBB) buffer->sbumpc();
+        if (buffer->sgetc() == 0xBF) buffer->sbumpc();
+    }
+}
+
+bool CsvReader::next(std::vector<std::string>& fields) {
+    fields.clear();
+    if (!buffer) return false;
+
+    std::string field;
+    bool inQuotes = false;
+    bool started = false;  // Seen any character of this record
+
+    while (true) {
+        int c = buffer->sbumpc();
+        if (c == std::char_traits<char>::eof()) {
+            if (!started) return false;
+            break;
+        }
+
+        if (inQuotes) {
+            if (c != '"') {
+                field += static_cast<char>(c);
+            } else if (buffer->sgetc() == '"') {
+                buffer->sbumpc();  // "" is an escaped quote
+                field += '"';
+            } else {
+                inQuotes = false;
+            }
+            continue;
+        }
+
+        if (c == '\r') continue;
+        if (c == '\n') {
+            if (!started) continue;  // Blank line
+            break;
+        }
+
+        started = true;
+        if (c == '"') {
+            inQuotes = true;
+        } else if (c == ',') {
+            fields.push_back(std::move(field));
+            field.clear();
+        } else {
+            field += static_cast<char>(c);
+        }
+    }
+
+    fields.push_back(std::move(field));
+    records++;
+    return true;
+}
@@ -0,0 +1,161 @@
+#include "../../include/Core/Database.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+
+std::string DatabaseConfig::defaultPath() {
+    if (const char* path = std::getenv("NOVA_DB_PATH")) {
+        if (*path) return path;
+    }
+    return "D:/Nova_Project/Nova_Backend/chatbot.db";
+}
+
+Database::Database(const DatabaseConfig& config) : dbPath(config.path) {
+    if (sqlite3_open(dbPath.c_str(), &db) != SQLITE_OK) {
+        std::cerr << "Can't open database " << dbPath << ": " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_close(db);
+        db = nullptr;
+        return;
+    }
+    sqlite3_busy_timeout(db, config.busyTimeoutMs);  // Other connections may briefly hold the write lock
+
+    // WAL with synchronous=NORMAL only syncs at checkpoints and stays safe across crashes
+    if (config.walMode) {
+        exec("PRAGMA journal_mode=WAL;");
+        exec("PRAGMA synchronous=NORMAL;");
+    }
+    exec(("PRAGMA cache_size=" + std::to_string(-config.cacheSizeKiB) + ";").c_str());
+    exec(("PRAGMA mmap_size=" + std::to_string(config.mmapSize) + ";").c_str());
+}
+
+Database::~Database() {
+    for (auto& [sql, entry] : cache) {
+        sqlite3_finalize(entry->stmt);
+    }
+    if (db) sqlite3_close(db);
+}
+
+Database::Statement Database::prepare(const std::string& sql) {
+    Statement statement;
+    if (!db) return statement;
+
+    auto& entry = cache[sql];
+    if (!entry) {
+        entry = std::make_unique<CachedStatement>();
+        entry->stats.sql = sql;
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &entry->stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << "\n  " << sql << std::endl;
+            cache.erase(sql);
+            return statement;
+        }
+    }
+
+    if (entry->inUse) {
+        // Same SQL is already on loan (e.g. a nested query); hand out a one-off copy
+        if (sqlite3_prepare_v2(db, sql.c_str(), -1, &statement.stmt, nullptr) != SQLITE_OK) {
+            std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
+            statement.stmt = nullptr;
+        }
+        return statement;
+    }
+
+    entry->inUse = true;
+    entry->stats.executions++;
+    statement.stmt = entry->stmt;
+    statement.entry = entry.get();
+    return statement;
+}
+
+bool Database::exec(const char* sql) {
+    if (!db) return false;
+    char* err = nullptr;
+    if (sqlite3_exec(db, sql, nullptr, nullptr, &err) != SQLITE_OK) {
+        std::cerr << "SQL error: " << (err ? err : "unknown") << std::endl;
+        sqlite3_free(err);
+        return false;
+    }
+    return true;
+}
+
+std::vector<Database::StatementStats> Database::statementStats() const {
+    std::vector<StatementStats> stats;
+    for (const auto& [sql, entry] : cache) {
+        stats.push_back(entry->stats);
+    }
+    std::sort(stats.begin(), stats.end(), [](const auto& a, const auto& b) { return a.totalMs > b.totalMs; });
+    return stats;
+}
+
+void Database::printStats(std::ostream& out) const {
+    out << "[Database] Statement stats for " << dbPath << std::endl;
+    for (const auto& s : statementStats()) {
+        out << "  " << s.executions << " runs, " << s.totalMs << " ms total: " << s.sql << std::endl;
+    }
+}
+
+Database::Statement::Statement(Statement&& other) noexcept : stmt(other.stmt), entry(other.entry) {
+    other.stmt = nullptr;
+    other.entry = nullptr;
+}
+
+Database::Statement& Database::Statement::operator=(Statement&& other) noexcept {
+    if (this != &other) {
+        release();
+        stmt = other.stmt;
+        entry = other.entry;
+        other.stmt = nullptr;
+        other.entry = nullptr;
+    }
+    return *this;
+}
+
+Database::Statement::~Statement() {
+    release();
+}
+
+int Database::Statement::step() {
+    auto start = std::chrono::steady_clock::now();
+    int rc = sqlite3_step(stmt);
+    if (entry) {
+        entry->stats.totalMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return rc;
+}
+
+void Database::Statement::release() {
+    if (!stmt) return;
+    if (entry) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+        entry->inUse = false;
+    } else {
+        sqlite3_finalize(stmt);
+    }
+    stmt = nullptr;
+    entry = nullptr;
+}
+
+DatabasePool::DatabasePool(DatabaseConfig config)
+    : settings(std::move(config)), primaryDb(std::make_unique<Database>(settings)) {
+    std::cout << "[Database] Using " << settings.path << (settings.walMode ? " (WAL)" : "") << std::endl;
+}
+
+std::unique_ptr<Database> DatabasePool::openConnection() const {
+    return std::make_unique<Database>(settings);
+}
+
+std::shared_ptr<DatabasePool> DatabasePool::defaultPool() {
+    static std::mutex mutex;
+    static std::weak_ptr<DatabasePool> current;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto pool = current.lock();
+    if (!pool) {
+        pool = std::make_shared<DatabasePool>();
+        current = pool;
+    }
+    return pool;
+}
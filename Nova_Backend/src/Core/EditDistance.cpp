@@ -0,0 +1,139 @@
+#include "../../include/Core/EditDistance.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+    // Per-thread scratch rows so the long-string fallbacks don't allocate per call
+    thread_local std::vector<int> scratchPrev;
+    thread_local std::vector<int> scratchCurr;
+
+    // Character match masks for the bit-parallel kernel; entries are reset after each use
+    thread_local uint64_t peq[256] = {};
+
+    const int kBandStack = 64;
+}
+
+int EditDistance::levenshtein(const std::string& a, const std::string& b) {
+    if (std::min(a.size(), b.size()) <= kMaxBitParallel) {
+        return myers(a, b);
+    }
+    return twoRow(a, b);
+}
+
+int EditDistance::myers(const std::string& a, const std::string& b) {
+    // Use the shorter string as the pattern so it fits in one machine word
+    const std::string& pattern = a.size() <= b.size() ? a : b;
+    const std::string& text = a.size() <= b.size() ? b : a;
+    const size_t m = pattern.size();
+
+    if (m == 0) return static_cast<int>(text.size());
+    if (m > kMaxBitParallel) return twoRow(a, b);
+
+    for (size_t i = 0; i < m; ++i) {
+        peq[static_cast<unsigned char>(pattern[i])] |= uint64_t(1) << i;
+    }
+
+    const uint64_t last = uint64_t(1) << (m - 1);
+    uint64_t pv = ~uint64_t(0);
+    uint64_t mv = 0;
+    int score = static_cast<int>(m);
+
+    for (unsigned char c : text) {
+        uint64_t eq = peq[c];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+
+        if (ph & last) ++score;
+        else if (mh & last) --score;
+
+        ph = (ph << 1) | 1;  // Row 0 grows by one per text character
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+    }
+
+    for (size_t i = 0; i < m; ++i) {
+        peq[static_cast<unsigned char>(pattern[i])] = 0;
+    }
+    return score;
+}
+
+int EditDistance::bounded(const std::string& a, const std::string& b, int maxDistance) {
+    const int n = static_cast<int>(a.size());
+    const int m = static_cast<int>(b.size());
+    const int k = std::max(maxDistance, 0);
+    const int over = k + 1;
+
+    if (std::abs(n - m) > k) return over;
+
+    // A wide band costs more than the bit-parallel kernel, which has no early exit but is O(n)
+    const int width = 2 * k + 1;
+    if (width > kBandStack || k >= std::max(n, m)) {
+        return std::min(levenshtein(a, b), over);
+    }
+
+    // Band cell t holds column j = i + t - k; values are capped at k + 1
+    int prevBuf[kBandStack];
+    int currBuf[kBandStack];
+    int* prev = prevBuf;
+    int* curr = currBuf;
+
+    for (int t = 0; t < width; ++t) {
+        int j = t - k;
+        prev[t] = (j >= 0 && j <= m) ? std::min(j, over) : over;
+    }
+
+    for (int i = 1; i <= n; ++i) {
+        int rowMin = over;
+        for (int t = 0; t < width; ++t) {
+            int j = i + t - k;
+            if (j < 0 || j > m) {
+                curr[t] = over;
+                continue;
+            }
+            int value;
+            if (j == 0) {
+                value = i;
+            } else {
+                value = prev[t] + (a[i - 1] != b[j - 1]);             // Substitution
+                if (t + 1 < width) value = std::min(value, prev[t + 1] + 1);  // Deletion
+                if (t > 0) value = std::min(value, curr[t - 1] + 1);          // Insertion
+            }
+            curr[t] = std::min(value, over);
+            rowMin = std::min(rowMin, curr[t]);
+        }
+        if (rowMin > k) return over;  // Every path already exceeds the threshold
+        std::swap(prev, curr);
+    }
+
+    return prev[m - n + k];
+}
+
+int EditDistance::twoRow(const std::string& a, const std::string& b) {
+    const size_t cols = b.size() + 1;
+    if (scratchPrev.size() < cols) {
+        scratchPrev.resize(cols);
+        scratchCurr.resize(cols);
+    }
+    int* prev = scratchPrev.data();
+    int* curr = scratchCurr.data();
+
+    for (size_t j = 0; j < cols; ++j) prev[j] = static_cast<int>(j);
+
+    for (size_t i = 1; i <= a.size(); ++i) {
+        curr[0] = static_cast<int>(i);
+        for (size_t j = 1; j < cols; ++j) {
+            curr[j] = std::min({
+                prev[j] + 1,                            // Deletion
+                curr[j - 1] + 1,                        // Insertion
+                prev[j - 1] + (a[i - 1] != b[j - 1])    // Substitution
+            });
+        }
+        std::swap(prev, curr);
+    }
+    return prev[b.size()];
+}
@@ -0,0 +1,93 @@
+#include "../../include/Core/EmbeddingStore.hpp"
+#include "../../include/Core/VectorCodec.hpp"
+#include <algorithm>
+#include <iostream>
+
+EmbeddingStore::EmbeddingStore(int dimension) : dim(dimension) {}
+
+void EmbeddingStore::load(sqlite3* db) {
+    words.clear();
+    rows.clear();
+    matrix.clear();
+
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT COUNT(*) FROM word_vectors;", -1, &stmt, nullptr) == SQLITE_OK) {
+        if (sqlite3_step(stmt) == SQLITE_ROW) {
+            size_t count = static_cast<size_t>(sqlite3_column_int64(stmt, 0));
+            words.reserve(count);
+            matrix.reserve(count * dim);
+        }
+        sqlite3_finalize(stmt);
+    }
+
+    if (sqlite3_prepare_v2(db, "SELECT word, vector FROM word_vectors;", -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "[EmbeddingStore] Failed to load word vectors: " << sqlite3_errmsg(db) << std::endl;
+        return;
+    }
+
+    std::vector<float> values;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const unsigned char* word = sqlite3_column_text(stmt, 0);
+        if (!word || !VectorCodec::readColumn(stmt, 1, values)) continue;
+        set(reinterpret_cast<const char*>(word), values);
+    }
+    sqlite3_finalize(stmt);
+
+    std::cout << "[EmbeddingStore] Loaded " << words.size() << " word vectors." << std::endl;
+}
+
+// The first decodable row decides; every row is written at the model's dimension
+int EmbeddingStore::detectDimension(sqlite3* db, int fallback) {
+    int dimension = fallback;
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "SELECT vector FROM word_vectors;", -1, &stmt, nullptr) == SQLITE_OK) {
+        std::vector<float> values;
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            if (VectorCodec::readColumn(stmt, 0, values) && !values.empty()) {
+                dimension = static_cast<int>(values.size());
+                break;
+            }
+        }
+        sqlite3_finalize(stmt);
+    }
+    return dimension;
+}
+
+uint32_t EmbeddingStore::set(std::string_view word, const std::vector<float>& vector) {
+    Vocabulary::Id id = Vocabulary::global().intern(word);
+    if (id >= rows.size()) rows.resize(static_cast<size_t>(id) + 1, kNoRow);
+    uint32_t row = rows[id];
+    if (row == kNoRow) {
+        row = static_cast<uint32_t>(words.size());
+        rows[id] = row;
+        words.push_back(id);
+        matrix.resize(matrix.size() + dim, 0.0f);
+    }
+
+    // Rows of a different length are truncated or zero-padded to the store's dimension
+    float* values = matrix.data() + static_cast<size_t>(row) * dim;
+    size_t n = std::min(vector.size(), static_cast<size_t>(dim));
+    std::copy(vector.begin(), vector.begin() + n, values);
+    std::fill(values + n, values + dim, 0.0f);
+    return row;
+}
+
+const float* EmbeddingStore::find(std::string_view word) const {
+    return words.empty() ? nullptr : find(Vocabulary::global().find(word));
+}
+
+// Ids interned elsewhere after the last set() are past the end of `rows`
+const float* EmbeddingStore::find(Vocabulary::Id word) const {
+    if (word >= rows.size() || rows[word] == kNoRow) return nullptr;
+    return vector(rows[word]);
+}
+
+int64_t EmbeddingStore::idOf(std::string_view word) const {
+    Vocabulary::Id id = Vocabulary::global().find(word);
+    if (id >= rows.size() || rows[id] == kNoRow) return -1;
+    return static_cast<int64_t>(rows[id]);
+}
+
+size_t EmbeddingStore::memoryUsage() const {
+    return words.capacity() * sizeof(Vocabulary::Id) + rows.capacity() * sizeof(uint32_t) + matrix.capacity() * sizeof(float);
+}
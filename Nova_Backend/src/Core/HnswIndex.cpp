@@ -0,0 +1,329 @@
+#include "../../include/Core/HnswIndex.hpp"
+#include "../../include/Core/VectorMath.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <queue>
+
+namespace {
+    const char kMagic[4] = {'N', 'V', 'H', 'N'};
+    const uint32_t kFileVersion = 1;
+
+    template <typename T>
+    void writePod(std::ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readPod(std::ifstream& in, T& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+}
+
+HnswIndex::HnswIndex(int dimension, size_t m, size_t efConstruction)
+    : dim(dimension), maxLinks(m), maxLinksBase(2 * m), efConstruction(efConstruction),
+      levelScale(1.0 / std::log(static_cast<double>(std::max<size_t>(m, 2)))) {}
+
+void HnswIndex::clear() {
+    keys.clear();
+    vectors.clear();
+    links.clear();
+    nodeOf.clear();
+    topLayer = -1;
+    entryPoint = 0;
+}
+
+float HnswIndex::similarity(const float* a, const float* b) const {
+    return VectorMath::dot(a, b, dim);
+}
+
+int HnswIndex::randomLayer() {
+    std::uniform_real_distribution<double> dist(std::numeric_limits<double>::min(), 1.0);
+    return static_cast<int>(-std::log(dist(rng)) * levelScale);
+}
+
+uint32_t HnswIndex::greedyClosest(const float* query, uint32_t start, int layer) const {
+    uint32_t current = start;
+    float best = similarity(query, nodeVector(current));
+    bool improved = true;
+    while (improved) {
+        improved = false;
+        for (uint32_t next : links[current][layer]) {
+            float s = similarity(query, nodeVector(next));
+            if (s > best) {
+                best = s;
+                current = next;
+                improved = true;
+            }
+        }
+    }
+    return current;
+}
+
+std::vector<HnswIndex::Scored> HnswIndex::searchLayer(const float* query, uint32_t start, size_t ef, int layer) const {
+    // Epoch per node, kept per thread so concurrent searches don't share marks; each search
+    // takes a new epoch, so marks left by other searches (or other indexes) never match
+    thread_local std::vector<uint32_t> visitedMark;
+    thread_local uint32_t visitEpoch = 0;
+    if (visitedMark.size() < keys.size()) visitedMark.resize(keys.size(), 0);
+    if (++visitEpoch == 0) {  // Epoch wrapped; reset marks
+        std::fill(visitedMark.begin(), visitedMark.end(), 0);
+        visitEpoch = 1;
+    }
+
+    std::priority_queue<Scored> candidates;  // Best first
+    std::priority_queue<Scored, std::vector<Scored>, std::greater<Scored>> found;  // Worst first
+
+    float s = similarity(query, nodeVector(start));
+    candidates.emplace(s, start);
+    found.emplace(s, start);
+    visitedMark[start] = visitEpoch;
+
+    while (!candidates.empty()) {
+        Scored current = candidates.top();
+        if (current.first < found.top().first && found.size() >= ef) break;  // Nothing better left
+        candidates.pop();
+
+        for (uint32_t next : links[current.second][layer]) {
+            if (visitedMark[next] == visitEpoch) continue;
+            visitedMark[next] = visitEpoch;
+
+            float score = similarity(query, nodeVector(next));
+            if (found.size() < ef || score > found.top().first) {
+                candidates.emplace(score, next);
+                found.emplace(score, next);
+                if (found.size() > ef) found.pop();
+            }
+        }
+    }
+
+    std::vector<Scored> result(found.size());
+    for (size_t i = result.size(); i-- > 0;) {
+        result[i] = found.top();
+        found.pop();
+    }
+    return result;
+}
+
+// Keeps a candidate only if it is closer to the query than to every neighbour
+// already kept, which spreads links across clusters instead of bunching them
+std::vector<uint32_t> HnswIndex::selectNeighbors(const std::vector<Scored>& candidates, size_t limit) const {
+    std::vector<uint32_t> selected;
+    std::vector<uint32_t> skipped;
+    for (const auto& [score, node] : candidates) {
+        if (selected.size() >= limit) break;
+        bool diverse = true;
+        for (uint32_t kept : selected) {
+            if (similarity(nodeVector(node), nodeVector(kept)) > score) {
+                diverse = false;
+                break;
+            }
+        }
+        (diverse ? selected : skipped).push_back(node);
+    }
+
+    // Top up with the best pruned candidates so sparse regions stay connected
+    for (uint32_t node : skipped) {
+        if (selected.size() >= limit) break;
+        selected.push_back(node);
+    }
+    return selected;
+}
+
+void HnswIndex::shrinkLinks(uint32_t node, int layer) {
+    auto& list = links[node][layer];
+    size_t limit = layer == 0 ? maxLinksBase : maxLinks;
+    if (list.size() <= limit) return;
+
+    std::vector<Scored> scored;
+    scored.reserve(list.size());
+    for (uint32_t other : list) {
+        scored.emplace_back(similarity(nodeVector(node), nodeVector(other)), other);
+    }
+    std::sort(scored.begin(), scored.end(), std::greater<Scored>());
+    list = selectNeighbors(scored, limit);
+}
+
+void HnswIndex::insert(const std::string& key, const float* vector) {
+    float norm = VectorMath::norm(vector, dim);
+    float scale = norm > 0.0f ? 1.0f / norm : 0.0f;
+
+    auto existing = nodeOf.find(key);
+    if (existing != nodeOf.end()) {
+        float* stored = vectors.data() + static_cast<size_t>(existing->second) * dim;
+        for (int i = 0; i < dim; ++i) stored[i] = vector[i] * scale;
+        return;
+    }
+
+    const uint32_t node = static_cast<uint32_t>(keys.size());
+    const int layer = randomLayer();
+    keys.push_back(key);
+    nodeOf.emplace(key, node);
+    for (int i = 0; i < dim; ++i) vectors.push_back(vector[i] * scale);
+    links.emplace_back(layer + 1);
+
+    if (topLayer < 0) {
+        entryPoint = node;
+        topLayer = layer;
+        return;
+    }
+
+    const float* query = nodeVector(node);
+    uint32_t current = entryPoint;
+    for (int l = topLayer; l > layer; --l) {
+        current = greedyClosest(query, current, l);
+    }
+
+    for (int l = std::min(layer, topLayer); l >= 0; --l) {
+        auto candidates = searchLayer(query, current, efConstruction, l);
+        links[node][l] = selectNeighbors(candidates, l == 0 ? maxLinksBase : maxLinks);
+        for (uint32_t neighbor : links[node][l]) {
+            links[neighbor][l].push_back(node);
+            shrinkLinks(neighbor, l);
+        }
+        current = candidates.front().second;
+    }
+
+    if (layer > topLayer) {
+        topLayer = layer;
+        entryPoint = node;
+    }
+}
+
+std::vector<std::pair<std::string, float>> HnswIndex::search(const std::vector<float>& query, size_t k, size_t ef) const {
+    std::vector<std::pair<std::string, float>> result;
+    if (keys.empty() || k == 0 || query.size() < static_cast<size_t>(dim)) return result;
+
+    float norm = VectorMath::norm(query.data(), dim);
+    if (norm == 0.0f) return result;
+
+    std::vector<float> q(query.begin(), query.begin() + dim);
+    for (float& v : q) v /= norm;
+
+    uint32_t current = entryPoint;
+    for (int l = topLayer; l > 0; --l) {
+        current = greedyClosest(q.data(), current, l);
+    }
+
+    auto found = searchLayer(q.data(), current, std::max(ef, k), 0);
+    for (size_t i = 0; i < found.size() && i < k; ++i) {
+        result.emplace_back(keys[found[i].second], found[i].first);
+    }
+    return result;
+}
+
+bool HnswIndex::save(const std::string& path) const {
+    std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            std::cerr << "[HnswIndex] Can't write " << tmpPath << std::endl;
+            return false;
+        }
+
+        out.write(kMagic, sizeof(kMagic));
+        writePod(out, kFileVersion);
+        writePod(out, static_cast<uint32_t>(dim));
+        writePod(out, static_cast<uint32_t>(maxLinks));
+        writePod(out, static_cast<uint32_t>(keys.size()));
+        writePod(out, static_cast<int32_t>(topLayer));
+        writePod(out, entryPoint);
+
+        for (uint32_t node = 0; node < keys.size(); ++node) {
+            writePod(out, static_cast<uint32_t>(keys[node].size()));
+            out.write(keys[node].data(), keys[node].size());
+            out.write(reinterpret_cast<const char*>(nodeVector(node)), dim * sizeof(float));
+            writePod(out, static_cast<uint32_t>(links[node].size()));
+            for (const auto& layerLinks : links[node]) {
+                writePod(out, static_cast<uint32_t>(layerLinks.size()));
+                out.write(reinterpret_cast<const char*>(layerLinks.data()), layerLinks.size() * sizeof(uint32_t));
+            }
+        }
+        if (!out) return false;
+    }
+
+    std::remove(path.c_str());  // rename() won't replace an existing file on Windows
+    return std::rename(tmpPath.c_str(), path.c_str()) == 0;
+}
+
+bool HnswIndex::load(const std::string& path) {
+    clear();
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) return false;
+    const std::streamoff fileSize = in.tellg();
+    in.seekg(0);
+
+    // Sizes read from the file must fit in what is left of it before anything is allocated
+    auto fits = [&](uint64_t count, uint64_t bytesEach) {
+        std::streamoff position = in.tellg();
+        return position >= 0 && count <= static_cast<uint64_t>(fileSize - position) / bytesEach;
+    };
+
+    char magic[4];
+    uint32_t version, fileDim, fileLinks, count, entry;
+    int32_t fileTop;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        !readPod(in, version) || version != kFileVersion ||
+        !readPod(in, fileDim) || static_cast<int>(fileDim) != dim ||
+        !readPod(in, fileLinks) || fileLinks != maxLinks ||
+        !readPod(in, count) || !readPod(in, fileTop) || !readPod(in, entry)) {
+        return false;
+    }
+
+    // Each node takes at least its key length, its vector and its layer count
+    bool valid = fits(count, 2 * sizeof(uint32_t) + dim * sizeof(float));
+    if (valid) {
+        keys.resize(count);
+        vectors.resize(static_cast<size_t>(count) * dim);
+        links.resize(count);
+    }
+    for (uint32_t node = 0; valid && node < count; ++node) {
+        uint32_t keyLength, layers;
+        if (!readPod(in, keyLength) || !fits(keyLength, 1)) {
+            valid = false;
+            break;
+        }
+        keys[node].resize(keyLength);
+        in.read(&keys[node][0], keyLength);
+        in.read(reinterpret_cast<char*>(vectors.data() + static_cast<size_t>(node) * dim), dim * sizeof(float));
+        if (!readPod(in, layers) || !fits(layers, sizeof(uint32_t))) {
+            valid = false;
+            break;
+        }
+        links[node].resize(layers);
+        for (auto& layerLinks : links[node]) {
+            uint32_t n;
+            if (!readPod(in, n) || !fits(n, sizeof(uint32_t))) {
+                valid = false;
+                break;
+            }
+            layerLinks.resize(n);
+            in.read(reinterpret_cast<char*>(layerLinks.data()), n * sizeof(uint32_t));
+        }
+        nodeOf.emplace(keys[node], node);
+    }
+
+    // The entry point must reach the top layer, and every link must point at a node that exists on that layer
+    valid = valid && static_cast<bool>(in) &&
+            (count == 0 || (entry < count && fileTop >= 0 && static_cast<size_t>(fileTop) < links[entry].size()));
+    for (uint32_t node = 0; valid && node < count; ++node) {
+        for (size_t layer = 0; layer < links[node].size(); ++layer) {
+            for (uint32_t next : links[node][layer]) {
+                if (next >= count || links[next].size() <= layer) valid = false;
+            }
+        }
+    }
+
+    if (!valid) {
+        std::cerr << "[HnswIndex] Ignoring corrupt index file " << path << std::endl;
+        clear();
+        return false;
+    }
+    topLayer = count ? fileTop : -1;
+    entryPoint = entry;
+    return true;
+}
@@ -0,0 +1,383 @@
+#include "../../include/Core/ModelFile.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    const char kMagic[8] = { 'N', 'O', 'V', 'A', 'M', 'D', 'L', '1' };
+    const size_t kMatrixAlignment = 64;
+    const uint32_t kEmptySlot = 0xFFFFFFFFu;
+    const char* const kSectionNames[2] = { "words", "responses" };
+
+    struct SectionHeader {
+        uint64_t count;
+        uint64_t stringOffsetsOffset;
+        uint64_t stringsOffset;
+        uint64_t stringsSize;
+        uint64_t hashOffset;
+        uint64_t hashSize;
+        uint64_t matrixOffset;
+    };
+
+    struct FileHeader {
+        char magic[8];
+        uint32_t version;
+        uint32_t dimension;
+        SectionHeader sections[2];
+    };
+    static_assert(sizeof(FileHeader) == 128, "FileHeader layout is part of the file format");
+
+    uint64_t alignUp(uint64_t value, uint64_t alignment) { return (value + alignment - 1) / alignment * alignment; }
+
+    uint64_t hashSlots(size_t count) {
+        uint64_t slots = 1;
+        while (slots < count * 2) slots <<= 1;  // Load factor <= 0.5
+        return count == 0 ? 0 : slots;
+    }
+
+    // Sequential writer that pads up to precomputed offsets
+    struct Writer {
+        FILE* file;
+        uint64_t position = 0;
+        bool ok = true;
+
+        void write(const void* data, size_t bytes) {
+            if (ok && bytes > 0 && std::fwrite(data, 1, bytes, file) != bytes) ok = false;
+            position += bytes;
+        }
+        void padTo(uint64_t offset) {
+            static const char zeros[kMatrixAlignment] = {};
+            while (position < offset) write(zeros, static_cast<size_t>(std::min<uint64_t>(offset - position, sizeof(zeros))));
+        }
+    };
+
+    std::string escapeKey(std::string_view key) {
+        std::string out;
+        for (char c : key) {
+            switch (c) {
+                case '\\': out += "\\\\"; break;
+                case '\t': out += "\\t"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                default: out += c;
+            }
+        }
+        return out;
+    }
+
+    std::string unescapeKey(const std::string& text) {
+        std::string out;
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] != '\\' || i + 1 == text.size()) {
+                out += text[i];
+                continue;
+            }
+            char c = text[++i];
+            out += c == 't' ? '\t' : c == 'n' ? '\n' : c == 'r' ? '\r' : c;
+        }
+        return out;
+    }
+}
+
+ModelFile::~ModelFile() {
+    close();
+}
+
+bool ModelFile::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize) || static_cast<uint64_t>(fileSize.QuadPart) < sizeof(FileHeader)) {
+        CloseHandle(file);
+        return false;
+    }
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);  // The mapping keeps the file open
+    if (!mapping) return false;
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    mappingHandle = mapping;
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<uint64_t>(info.st_size) < sizeof(FileHeader)) {
+        ::close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping keeps the file open
+    if (view == MAP_FAILED) return false;
+    mappedSize = static_cast<size_t>(info.st_size);
+#endif
+    base = static_cast<const unsigned char*>(view);
+    filePath = path;
+
+    // Only the header and section bounds are checked here, so opening stays O(1)
+    FileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    bool valid = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion && header.dimension > 0;
+    auto fits = [this](uint64_t offset, uint64_t bytes) { return offset <= mappedSize && bytes <= mappedSize - offset; };
+
+    for (int s = 0; valid && s < 2; ++s) {
+        const SectionHeader& h = header.sections[s];
+        uint64_t rowBytes = static_cast<uint64_t>(header.dimension) * sizeof(float);
+        valid = h.count < kEmptySlot && h.count <= mappedSize / rowBytes &&
+                h.stringOffsetsOffset % alignof(uint64_t) == 0 && fits(h.stringOffsetsOffset, (h.count + 1) * sizeof(uint64_t)) &&
+                fits(h.stringsOffset, h.stringsSize) &&
+                h.hashOffset % alignof(uint32_t) == 0 && h.hashSize == hashSlots(h.count) &&
+                fits(h.hashOffset, h.hashSize * sizeof(uint32_t)) &&
+                h.matrixOffset % kMatrixAlignment == 0 && fits(h.matrixOffset, h.count * rowBytes);
+        if (!valid) break;
+
+        SectionView& section = sections[s];
+        section.count = static_cast<size_t>(h.count);
+        section.stringOffsets = reinterpret_cast<const uint64_t*>(base + h.stringOffsetsOffset);
+        section.strings = reinterpret_cast<const char*>(base + h.stringsOffset);
+        section.stringsSize = static_cast<size_t>(h.stringsSize);
+        section.hash = reinterpret_cast<const uint32_t*>(base + h.hashOffset);
+        section.hashSize = static_cast<size_t>(h.hashSize);
+        section.matrix = reinterpret_cast<const float*>(base + h.matrixOffset);
+    }
+
+    if (!valid) {
+        std::cerr << "[ModelFile] " << path << " is not a version " << kVersion << " model file." << std::endl;
+        close();
+        return false;
+    }
+    dim = static_cast<int>(header.dimension);
+    return true;
+}
+
+void ModelFile::close() {
+    if (base) {
+#ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle(static_cast<HANDLE>(mappingHandle));
+#else
+        munmap(const_cast<unsigned char*>(base), mappedSize);
+#endif
+    }
+    base = nullptr;
+    mappedSize = 0;
+    mappingHandle = nullptr;
+    dim = 0;
+    sections[Words] = SectionView();
+    sections[Responses] = SectionView();
+    filePath.clear();
+}
+
+std::string_view ModelFile::key(Section section, size_t row) const {
+    const SectionView& view = sections[section];
+    if (row >= view.count) return {};
+    uint64_t begin = view.stringOffsets[row], end = view.stringOffsets[row + 1];
+    if (begin > end || end > view.stringsSize) return {};  // Corrupt offsets read as an empty key
+    return std::string_view(view.strings + begin, static_cast<size_t>(end - begin));
+}
+
+const float* ModelFile::vector(Section section, size_t row) const {
+    const SectionView& view = sections[section];
+    return row < view.count ? view.matrix + row * dim : nullptr;
+}
+
+const float* ModelFile::find(Section section, std::string_view k) const {
+    const SectionView& view = sections[section];
+    if (view.hashSize == 0) return nullptr;
+
+    size_t mask = view.hashSize - 1;
+    size_t slot = static_cast<size_t>(hashKey(k)) & mask;
+    for (size_t probes = 0; probes < view.hashSize; ++probes, slot = (slot + 1) & mask) {
+        uint32_t row = view.hash[slot];
+        if (row == kEmptySlot) return nullptr;
+        if (key(section, row) == k) return vector(section, row);
+    }
+    return nullptr;
+}
+
+uint64_t ModelFile::hashKey(std::string_view k) {
+    uint64_t hash = 1469598103934665603ull;  // FNV-1a
+    for (char c : k) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool ModelFile::isModelFile(const std::string& path) {
+    char magic[sizeof(kMagic)] = {};
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) return false;
+    size_t read = std::fread(magic, 1, sizeof(magic), file);
+    std::fclose(file);
+    return read == sizeof(magic) && std::memcmp(magic, kMagic, sizeof(kMagic)) == 0;
+}
+
+bool ModelFile::save(const std::string& path, const Data& data) {
+    if (data.dimension <= 0) {
+        std::cerr << "[ModelFile] Refusing to save a model without a dimension." << std::endl;
+        return false;
+    }
+    for (int s = 0; s < 2; ++s) {
+        if (data.vectors[s].size() != data.keys[s].size() * static_cast<size_t>(data.dimension)) {
+            std::cerr << "[ModelFile] " << kSectionNames[s] << ": " << data.keys[s].size() << " keys but "
+                      << data.vectors[s].size() << " floats." << std::endl;
+            return false;
+        }
+    }
+
+    // Lay out every section before writing anything
+    FileHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.dimension = static_cast<uint32_t>(data.dimension);
+
+    std::vector<uint64_t> stringOffsets[2];
+    std::vector<uint32_t> hashes[2];
+    uint64_t position = sizeof(FileHeader);
+    for (int s = 0; s < 2; ++s) {
+        const auto& keys = data.keys[s];
+        SectionHeader& h = header.sections[s];
+        h.count = keys.size();
+
+        stringOffsets[s].reserve(keys.size() + 1);
+        uint64_t bytes = 0;
+        for (const auto& k : keys) {
+            stringOffsets[s].push_back(bytes);
+            bytes += k.size();
+        }
+        stringOffsets[s].push_back(bytes);
+
+        // Later duplicates win, matching INSERT OR REPLACE
+        h.hashSize = hashSlots(keys.size());
+        hashes[s].assign(static_cast<size_t>(h.hashSize), kEmptySlot);
+        size_t mask = static_cast<size_t>(h.hashSize) - 1;
+        for (uint32_t row = 0; row < keys.size(); ++row) {
+            size_t slot = static_cast<size_t>(hashKey(keys[row])) & mask;
+            while (hashes[s][slot] != kEmptySlot && keys[hashes[s][slot]] != keys[row]) slot = (slot + 1) & mask;
+            hashes[s][slot] = row;
+        }
+
+        h.stringOffsetsOffset = alignUp(position, alignof(uint64_t));
+        h.stringsOffset = h.stringOffsetsOffset + stringOffsets[s].size() * sizeof(uint64_t);
+        h.stringsSize = bytes;
+        h.hashOffset = alignUp(h.stringsOffset + bytes, alignof(uint64_t));
+        h.matrixOffset = alignUp(h.hashOffset + h.hashSize * sizeof(uint32_t), kMatrixAlignment);
+        position = h.matrixOffset + data.vectors[s].size() * sizeof(float);
+    }
+
+    std::string tempPath = path + ".tmp";
+    FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (!file) {
+        std::cerr << "[ModelFile] Cannot write " << tempPath << std::endl;
+        return false;
+    }
+
+    Writer out{ file };
+    out.write(&header, sizeof(header));
+    for (int s = 0; s < 2; ++s) {
+        const SectionHeader& h = header.sections[s];
+        out.padTo(h.stringOffsetsOffset);
+        out.write(stringOffsets[s].data(), stringOffsets[s].size() * sizeof(uint64_t));
+        for (const auto& k : data.keys[s]) out.write(k.data(), k.size());
+        out.padTo(h.hashOffset);
+        out.write(hashes[s].data(), hashes[s].size() * sizeof(uint32_t));
+        out.padTo(h.matrixOffset);
+        out.write(data.vectors[s].data(), data.vectors[s].size() * sizeof(float));
+    }
+
+    // Make the contents durable before the rename publishes them
+    bool ok = out.ok && std::fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = std::fclose(file) == 0 && ok;
+
+    std::error_code error;
+    if (ok) std::filesystem::rename(tempPath, path, error);
+    if (!ok || error) {
+        std::cerr << "[ModelFile] Failed to save " << path << (error ? ": " + error.message() : "") << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+bool ModelFile::exportText(const ModelFile& model, std::ostream& out) {
+    if (!model.isOpen()) return false;
+    out << "nova-model " << kVersion << " " << model.dimension() << "\n";
+    out << std::setprecision(std::numeric_limits<float>::max_digits10);
+    for (int s = 0; s < 2; ++s) {
+        Section section = static_cast<Section>(s);
+        out << kSectionNames[s] << " " << model.size(section) << "\n";
+        for (size_t row = 0; row < model.size(section); ++row) {
+            out << escapeKey(model.key(section, row)) << '\t';
+            const float* values = model.vector(section, row);
+            for (int i = 0; i < model.dimension(); ++i) out << (i ? " " : "") << values[i];
+            out << "\n";
+        }
+    }
+    return static_cast<bool>(out);
+}
+
+bool ModelFile::importText(std::istream& in, Data& data) {
+    std::string line, tag;
+    uint32_t version = 0;
+    data = Data();
+    if (!std::getline(in, line) || !(std::istringstream(line) >> tag >> version >> data.dimension) ||
+        tag != "nova-model" || version != kVersion || data.dimension <= 0) {
+        std::cerr << "[ModelFile] Expected a \"nova-model " << kVersion << " <dimension>\" first line." << std::endl;
+        return false;
+    }
+
+    for (int s = 0; s < 2; ++s) {
+        size_t count = 0;
+        if (!std::getline(in, line) || !(std::istringstream(line) >> tag >> count) || tag != kSectionNames[s]) {
+            std::cerr << "[ModelFile] Expected a \"" << kSectionNames[s] << " <count>\" line." << std::endl;
+            return false;
+        }
+        for (size_t row = 0; row < count; ++row) {
+            size_t tab;
+            if (!std::getline(in, line) || (tab = line.find('\t')) == std::string::npos) {
+                std::cerr << "[ModelFile] " << kSectionNames[s] << " row " << row + 1 << " is missing or has no tab." << std::endl;
+                return false;
+            }
+            data.keys[s].push_back(unescapeKey(line.substr(0, tab)));
+
+            std::istringstream values(line.substr(tab + 1));
+            float value;
+            int n = 0;
+            for (; values >> value; ++n) data.vectors[s].push_back(value);
+            if (n != data.dimension) {
+                std::cerr << "[ModelFile] " << kSectionNames[s] << " row " << row + 1 << " has " << n
+                          << " values, expected " << data.dimension << "." << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
@@ -1,4 +1,7 @@
 #include "../../include/Core/NeuralNet.hpp"
+#include "../../include/Core/VectorCodec.hpp"
+#include "../../include/Core/ThreadPool.hpp"
+#include "../../include/Core/VectorMath.hpp"
 #include <sstream>
 #include <cctype>
 #include <map>
@@ -6,24 +9,84 @@
 #include <iostream>
 #include <random>
 #include <fstream>
-#include <sstream>
+#include <chrono>
+#include <limits>
+
+// Constructor: Take the shared database connection and ensure necessary table
+NeuralNet::NeuralNet(std::shared_ptr<DatabasePool> databasePool, WarmUp warmUp)
+    : pool(std::move(databasePool)), dbPath(pool->config().path), db(pool->primary()),
+      embeddingSize(EmbeddingStore::detectDimension(db.handle(), kDefaultEmbeddingSize)),
+      embeddings(embeddingSize), pretrained(embeddingSize), wordIndex(embeddingSize), wordAnn(embeddingSize) {
+    ensureTable(db);  // Ensure table exists
+    setDimension(embeddingSize);
+
+    if (warmUp == WarmUp::Eager) {
+        loadEmbeddings();
+        buildIndexes();
+    }
+
+    // Updated vectors are persisted on a second connection by a background writer
+    writerDb = pool->openConnection();
+    writerThread = std::thread(&NeuralNet::writerLoop, this);
+}
+
+void NeuralNet::loadEmbeddings() {
+    // Convert rows still stored as decimal text to the binary encoding (no-op once done)
+    VectorCodec::migrateTextRows(db.handle());
+
+    // Keep the whole word_vectors table resident so vectorize never queries SQLite
+    embeddings.load(db.handle());
+    modelChanged();
+}
+
+void NeuralNet::buildIndexes() {
+    wordIndex.build(embeddings);
+    loadAnnIndexes();
+}
+
+// Destructor: Flush pending vector writes; the pool closes the shared connection
+NeuralNet::~NeuralNet() {
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        stopWriter = true;
+    }
+    writerCv.notify_all();
+    if (writerThread.joinable()) writerThread.join();
+    writerDb.reset();
 
-// Constructor: Initialize database connection and ensure necessary table
-NeuralNet::NeuralNet() 
-    : db(nullptr, sqlite3_close) {
-    sqlite3* rawDb = nullptr;
-    if (sqlite3_open("D:/Nova_Project/Nova_Backend/chatbot.db", &rawDb) != SQLITE_OK) {
-        std::cerr << "Can't open database: " << sqlite3_errmsg(db.get()) << std::endl;
+    if (annDirty) saveAnnIndexes();
+}
+
+// Load the persisted HNSW index; the word graph is only built once the vocabulary needs it
+void NeuralNet::loadAnnIndexes() {
+    bool loaded = wordAnn.load(dbPath + ".words.hnsw");
+    if (loaded || embeddings.size() >= kAnnThreshold) {
+        buildWordAnn();
+        annDirty = !loaded;
     }
-    db.reset(rawDb);  // Use unique_ptr to manage db connection
-    ensureTable(db.get());  // Ensure table exists
+
+    std::cout << "[NeuralNet] ANN index ready (" << wordAnn.size() << " words"
+              << (loaded ? ", loaded from disk" : "") << ")." << std::endl;
 }
 
-// Destructor: Automatically closes the database connection
-NeuralNet::~NeuralNet() {}
+// Inserting refreshes vectors that changed since the graph was saved and adds new words
+void NeuralNet::buildWordAnn() {
+    for (uint32_t id = 0; id < embeddings.size(); ++id) {
+        wordAnn.insert(std::string(embeddings.word(id)), embeddings.vector(id));
+    }
+    wordAnnEnabled = true;
+}
 
-// Ensure word_vectors table exists in the database
-void NeuralNet::ensureTable(sqlite3* db) {
+void NeuralNet::saveAnnIndexes() {
+    if (wordAnnEnabled && !wordAnn.save(dbPath + ".words.hnsw")) {
+        std::cerr << "Error saving ANN index next to " << dbPath << std::endl;
+        return;
+    }
+    annDirty = false;
+}
+
+// Ensure word_vectors exists in the database
+void NeuralNet::ensureTable(Database& db) {
     const char* createTableQuery = R"(
         CREATE TABLE IF NOT EXISTS word_vectors (
             word TEXT PRIMARY KEY,
@@ -31,33 +94,30 @@ void NeuralNet::ensureTable(sqlite3* db) {
         );
     )";
 
-    char* errMessage;
-    if (sqlite3_exec(db, createTableQuery, nullptr, nullptr, &errMessage) != SQLITE_OK) {
-        std::cerr << "Error creating table: " << errMessage << std::endl;
-        sqlite3_free(errMessage);
-    } else {
+    if (db.exec(createTableQuery)) {
         std::cout << "Table 'word_vectors' ensured in the database." << std::endl;
     }
 }
 
 // Check if the word_vectors table is empty
-bool NeuralNet::isTableEmpty(sqlite3* db) {
-    const char* sql = "SELECT COUNT(*) FROM word_vectors;";
-    sqlite3_stmt* stmt;
+bool NeuralNet::isTableEmpty(Database& db) {
+    auto stmt = db.prepare("SELECT COUNT(*) FROM word_vectors;");
     int count = 0;
     
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            count = sqlite3_column_int(stmt, 0);
-        }
-        sqlite3_finalize(stmt);
+    if (stmt && stmt.step() == SQLITE_ROW) {
+        count = sqlite3_column_int(stmt, 0);
     }
     
     return count == 0;  // If the count is 0, the table is empty
 }
 
 void NeuralNet::importModelToDatabase(const std::string& filename) {
-    // Open the model file and import data as before
+    if (ModelFile::isModelFile(filename)) {
+        importBinaryModel(filename);
+        return;
+    }
+
+    // Legacy text model: one "word v1 v2 ..." row per line
     std::ifstream modelFile(filename);
     if (!modelFile.is_open()) {
         std::cerr << "Error opening model file: " << filename << std::endl;
@@ -65,12 +125,36 @@ void NeuralNet::importModelToDatabase(const std::string& filename) {
     }
 
     // Check if the table is empty before proceeding with import
-    if (!isTableEmpty(db.get())) {
+    if (!isTableEmpty(db)) {
         std::cout << "Table 'word_vectors' is not empty. Skipping import." << std::endl;
         return;
     }
 
+    // The file decides the dimension: a word2vec "<count> <dimension>" header, else the first row's length
     std::string line;
+    int fileDimension = 0;
+    std::streampos firstRow = modelFile.tellg();
+    if (std::getline(modelFile, line)) {
+        std::istringstream header(line);
+        std::string word;
+        long long count = 0;
+        float value;
+        if (header >> count >> fileDimension && !(header >> word)) {
+            firstRow = modelFile.tellg();
+        } else {
+            std::istringstream row(line);
+            row >> word;
+            for (fileDimension = 0; row >> value; ++fileDimension) {}
+        }
+    }
+    modelFile.clear();
+    modelFile.seekg(firstRow);
+
+    if (fileDimension > 0 && fileDimension != embeddingSize) {
+        std::cout << "Model file holds " << fileDimension << "-dimensional vectors; switching from " << embeddingSize << "." << std::endl;
+        setDimension(fileDimension);
+    }
+
     while (std::getline(modelFile, line)) {
         std::istringstream lineStream(line);
         std::string word;
@@ -90,48 +174,130 @@ void NeuralNet::importModelToDatabase(const std::string& filename) {
             continue;
         }
 
-        // Convert embedding to string format for insertion
-        std::ostringstream vectorStream;
-        for (const auto& val : embedding) {
-            vectorStream << val << " ";
-        }
-        std::string vectorData = vectorStream.str();
-
         // Insert word and its vector into the database
-        const char* insertQuery = "INSERT OR REPLACE INTO word_vectors (word, vector) VALUES (?, ?);";
-        sqlite3_stmt* stmt;
-        if (sqlite3_prepare_v2(db.get(), insertQuery, -1, &stmt, nullptr) != SQLITE_OK) {
-            std::cerr << "Failed to prepare insert statement: " << sqlite3_errmsg(db.get()) << std::endl;
+        auto stmt = db.prepare("INSERT OR REPLACE INTO word_vectors (word, vector) VALUES (?, ?);");
+        if (!stmt) {
             continue;
         }
 
         sqlite3_bind_text(stmt, 1, word.c_str(), -1, SQLITE_STATIC);  // Bind word
-        sqlite3_bind_text(stmt, 2, vectorData.c_str(), -1, SQLITE_STATIC);  // Bind vector data
-        if (sqlite3_step(stmt) != SQLITE_DONE) {
-            std::cerr << "Failed to insert data for " << word << ": " << sqlite3_errmsg(db.get()) << std::endl;
+        VectorCodec::bindVector(stmt, 2, embedding);  // Bind vector as a binary blob
+        if (stmt.step() != SQLITE_DONE) {
+            std::cerr << "Failed to insert data for " << word << ": " << db.errorMessage() << std::endl;
+        } else {
+            setTokenVector(word, embedding);  // Mirror into the resident table
         }
-        sqlite3_finalize(stmt);
     }
 
     modelFile.close();
     std::cout << "Model imported into database successfully!" << std::endl;
 }
 
-std::vector<float> NeuralNet::vectorize(const std::string& input) {
-    std::vector<float> embedding(embeddingSize, 0.0f);  // Initialize the embedding with zeros
+// Select the vectorize specialization for `dimension` and reset everything sized by it
+void NeuralNet::setDimension(int dimension) {
+    modelChanged();
+    if (dimension != embeddingSize) {
+        embeddingSize = dimension;
+        embeddings = EmbeddingStore(dimension);
+        pretrained = EmbeddingStore(dimension);
+        wordIndex = SimilarityIndex(dimension);
+        wordAnn = HnswIndex(dimension);
+        wordAnnEnabled = false;
+    }
 
-    // Tokenize the input string by spaces
-    std::istringstream tokenStream(input);
-    std::string token;
-    int wordCount = 0;  // Count the number of valid words in the input
+    vectorizeImpl = &NeuralNet::vectorizeGeneric;
+    bool specialized = dispatchDimension(dimension, [this](auto n) {
+        vectorizeImpl = &NeuralNet::vectorizeFixed<decltype(n)::value>;
+    });
+    std::cout << "[NeuralNet] " << dimension << "-dimensional embeddings ("
+              << (specialized ? "specialized" : "generic") << " kernels)." << std::endl;
+}
 
-    while (tokenStream >> token) {
-        // Retrieve the embedding for this token (word)
-        auto wordVector = getTokenVector(token);
+// Copy the words of a binary model into the empty word_vectors table, in one transaction
+void NeuralNet::importBinaryModel(const std::string& filename) {
+    if (!isTableEmpty(db)) {
+        std::cout << "Table 'word_vectors' is not empty. Skipping import." << std::endl;
+        return;
+    }
 
-        // Add this word's vector to the overall embedding
-        for (int i = 0; i < embeddingSize; ++i) {
-            embedding[i] += wordVector[i];
+    ModelFile opened;
+    const ModelFile* source = &model;
+    if (model.path() != filename) {
+        if (!opened.open(filename)) {
+            std::cerr << "Error opening model file: " << filename << std::endl;
+            return;
+        }
+        source = &opened;
+    }
+
+    if (source->dimension() != embeddingSize) {
+        std::cout << "Model file holds " << source->dimension() << "-dimensional vectors; switching from " << embeddingSize << "." << std::endl;
+        setDimension(source->dimension());
+    }
+
+    size_t imported = 0;
+    std::vector<float> embedding(embeddingSize);
+    db.exec("BEGIN;");
+    for (size_t row = 0; row < source->size(ModelFile::Words); ++row) {
+        std::string word(source->key(ModelFile::Words, row));
+        const float* values = source->vector(ModelFile::Words, row);
+        embedding.assign(values, values + embeddingSize);
+
+        auto stmt = db.prepare("INSERT OR REPLACE INTO word_vectors (word, vector) VALUES (?, ?);");
+        if (!stmt) break;
+        sqlite3_bind_text(stmt, 1, word.c_str(), -1, SQLITE_STATIC);
+        VectorCodec::bindVector(stmt, 2, embedding);
+        if (stmt.step() != SQLITE_DONE) {
+            std::cerr << "Failed to insert data for " << word << ": " << db.errorMessage() << std::endl;
+            continue;
+        }
+        setTokenVector(word, embedding);  // Mirror into the resident table
+        imported++;
+    }
+    db.exec("COMMIT;");
+    std::cout << "Imported " << imported << " word vectors from " << filename << "." << std::endl;
+}
+
+std::vector<float> NeuralNet::vectorize(const std::string& input) const {
+    std::vector<float> embedding(embeddingSize, 0.0f);
+    vectorizeInto(input, embedding.data(), true);
+    return embedding;
+}
+
+// Mean of the token vectors, scaled to unit length; safe to call from several threads
+void NeuralNet::vectorizeInto(std::string_view input, float* embedding, bool logMisses) const {
+    (this->*vectorizeImpl)(input, embedding, logMisses);
+}
+
+// Same steps as vectorizeGeneric, with the sum kept in aligned stack storage of a known length
+template <int N>
+void NeuralNet::vectorizeFixed(std::string_view input, float* embedding, bool logMisses) const {
+    Embedding<N> sum;
+    EmbeddingKernels::zero<N>(sum.data());
+    int wordCount = 0;
+
+    for (const auto& token : Tokenizer::local().tokenize(input)) {
+        if (const float* wordVector = lookupWord(token, logMisses)) {
+            EmbeddingKernels::add<N>(wordVector, sum.data());
+        }
+        wordCount++;
+    }
+
+    if (wordCount > 0) EmbeddingKernels::scale<N>(sum.data(), 1.0f / wordCount);
+    float norm = EmbeddingKernels::norm<N>(sum.data());
+    if (norm > 0) EmbeddingKernels::scale<N>(sum.data(), 1.0f / norm);
+    EmbeddingKernels::copy<N>(sum.data(), embedding);
+}
+
+void NeuralNet::vectorizeGeneric(std::string_view input, float* embedding, bool logMisses) const {
+    std::fill(embedding, embedding + embeddingSize, 0.0f);  // Initialize the embedding with zeros
+    int wordCount = 0;  // Count the number of valid words in the input
+
+    // Tokenize the input into normalized words
+    for (const auto& token : Tokenizer::local().tokenize(input)) {
+        // Retrieve the embedding for this token (word); unknown words count as zero vectors
+        if (const float* wordVector = lookupWord(token, logMisses)) {
+            VectorMath::axpy(1.0f, wordVector, embedding, embeddingSize);
         }
 
         wordCount++;  // Increment the word count
@@ -145,19 +311,13 @@ std::vector<float> NeuralNet::vectorize(const std::string& input) {
     }
 
     // Normalize the vector (optional, for unit length or other transformations)
-    float norm = 0.0f;
-    for (float val : embedding) {
-        norm += val * val;
-    }
-    norm = std::sqrt(norm);
+    float norm = VectorMath::norm(embedding, embeddingSize);
 
     if (norm > 0) {
-        for (float& val : embedding) {
-            val /= norm;  // Normalize each element
+        for (int i = 0; i < embeddingSize; ++i) {
+            embedding[i] /= norm;  // Normalize each element
         }
     }
-
-    return embedding;
 }
 
 // Helper: Generate a random vector (for unseen words)
@@ -175,8 +335,6 @@ std::vector<float> NeuralNet::vectorize(const std::string& input) {
 // }
 
 
-std::unordered_map<std::string, std::vector<float>> pretrainedEmbeddings;
-
 void NeuralNet::loadPretrainedEmbeddings(const std::string& filename) {
     std::ifstream file(filename);
     std::string word;
@@ -185,30 +343,60 @@ void NeuralNet::loadPretrainedEmbeddings(const std::string& filename) {
         for (int i = 0; i < embeddingSize; ++i) {
             file >> embedding[i];
         }
-        pretrainedEmbeddings[word] = embedding;
+        pretrained.set(word, embedding);
     }
+    modelChanged();
     std::cout << "Pre-trained embeddings loaded successfully!" << std::endl;
 }
 
+// Queue a token's vector for the background writer; repeated updates coalesce
 void NeuralNet::storeTokenVector(const std::string& token, const std::vector<float>& vector) {
-    const char* sql = "INSERT OR REPLACE INTO word_vectors (word, vector) VALUES (?, ?);";
-    sqlite3_stmt* stmt;
+    {
+        std::lock_guard<std::mutex> lock(writerMutex);
+        pendingVectors[token] = vector;
+    }
+    writerCv.notify_one();
+}
 
-    // Convert vector to a string for insertion
-    std::ostringstream vecStream;
-    for (float val : vector) {
-        vecStream << val << " ";
+void NeuralNet::writerLoop() {
+    std::unique_lock<std::mutex> lock(writerMutex);
+    while (true) {
+        writerCv.wait(lock, [this] { return stopWriter || !pendingVectors.empty(); });
+        if (pendingVectors.empty()) break;  // Stopping with nothing left to write
+
+        std::unordered_map<std::string, std::vector<float>> batch;
+        batch.swap(pendingVectors);
+        writerBusy = true;
+        lock.unlock();
+
+        writeVectors(batch);
+
+        lock.lock();
+        writerBusy = false;
+        writerCv.notify_all();  // Wake flushTokenVectors()
     }
-    std::string vectorData = vecStream.str();
+}
+
+// Write a batch of token vectors in a single transaction
+void NeuralNet::writeVectors(const std::unordered_map<std::string, std::vector<float>>& batch) {
+    if (!writerDb || !writerDb->isOpen()) return;
 
-    if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) == SQLITE_OK) {
+    writerDb->exec("BEGIN;");
+    for (const auto& [token, vector] : batch) {
+        auto stmt = writerDb->prepare("INSERT OR REPLACE INTO word_vectors (word, vector) VALUES (?, ?);");
+        if (!stmt) break;
         sqlite3_bind_text(stmt, 1, token.c_str(), -1, SQLITE_STATIC);  // Bind word
-        sqlite3_bind_text(stmt, 2, vectorData.c_str(), -1, SQLITE_STATIC);  // Bind vector
-        sqlite3_step(stmt);  // Execute the statement (store the vector)
-        sqlite3_finalize(stmt);
-    } else {
-        std::cerr << "Error storing vector for " << token << ": " << sqlite3_errmsg(db.get()) << std::endl;
+        VectorCodec::bindVector(stmt, 2, vector);  // Bind vector as a binary blob
+        if (stmt.step() != SQLITE_DONE) {
+            std::cerr << "Error storing vector for " << token << ": " << writerDb->errorMessage() << std::endl;
+        }
     }
+    writerDb->exec("COMMIT;");
+}
+
+void NeuralNet::flushTokenVectors() {
+    std::unique_lock<std::mutex> lock(writerMutex);
+    writerCv.wait(lock, [this] { return pendingVectors.empty() && !writerBusy; });
 }
 
 
@@ -228,222 +416,480 @@ void NeuralNet::reinforce(const std::string& input, const std::string& response)
 }
 
 
-void NeuralNet::saveModelToFile(const std::string& filename) {
-    std::ofstream modelFile(filename, std::ios::app);  // Open file for appending
-    
-    if (!modelFile) {
-        std::cerr << "Error opening file for saving model: " << filename << std::endl;
-        return;
-    }
-
-    const char* sql = "SELECT topic, response FROM responses;";  // Query all responses from the database
-    sqlite3_stmt* stmt;
+// Snapshot the resident word vectors and one embedding per distinct response
+bool NeuralNet::saveModelToFile(const std::string& filename) {
+    ModelFile::Data data;
+    data.dimension = embeddingSize;
 
-    // Prepare the query to get responses from the 'responses' table
-    if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare SQL query: " << sqlite3_errmsg(db.get()) << std::endl;
-        return;
+    auto& words = data.keys[ModelFile::Words];
+    auto& wordVectors = data.vectors[ModelFile::Words];
+    words.reserve(embeddings.size());
+    wordVectors.reserve(embeddings.size() * embeddingSize);
+    for (uint32_t id = 0; id < embeddings.size(); ++id) {
+        words.emplace_back(embeddings.word(id));
+        wordVectors.insert(wordVectors.end(), embeddings.vector(id), embeddings.vector(id) + embeddingSize);
     }
 
-    // Loop through each response from the database
-    while (sqlite3_step(stmt) == SQLITE_ROW) {
-        std::string topic = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-        std::string response = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+    {
+        auto stmt = db.prepare("SELECT DISTINCT response FROM responses;");
+        if (!stmt) {
+            return false;
+        }
+        auto& responses = data.keys[ModelFile::Responses];
+        auto& responseVectors = data.vectors[ModelFile::Responses];
+        while (stmt.step() == SQLITE_ROW) {
+            const unsigned char* text = sqlite3_column_text(stmt, 0);
+            if (!text) continue;
+            responses.emplace_back(reinterpret_cast<const char*>(text));
+            responseVectors.resize(responseVectors.size() + embeddingSize);
+            vectorizeInto(responses.back(), responseVectors.data() + responseVectors.size() - embeddingSize, false);
+        }
+    }
 
-        // Vectorize the response
-        std::vector<float> responseVector = vectorize(response);  // Get the vector for the response
+    // Unmap first: Windows cannot replace a file that is still mapped
+    bool remap = model.path() == filename;
+    if (remap) model.close();
+    bool saved = ModelFile::save(filename, data);
+    if (remap) model.open(filename);
 
-        // Write the word and its vector to the file
-        modelFile << response << " ";  // Write the response
-        for (const auto& value : responseVector) {
-            modelFile << value << " ";  // Write the vector elements
+    if (saved) {
+        std::cout << "Model saved to " << filename << " (" << words.size() << " words, "
+                  << data.keys[ModelFile::Responses].size() << " responses)." << std::endl;
+    }
+    return saved;
+}
+const float* NeuralNet::lookupToken(std::string_view token, bool logMiss) const {
+    // One vocabulary lookup serves the pre-trained embeddings and then the resident word_vectors table
+    Vocabulary::Id id = Vocabulary::global().find(token);
+    if (id != Vocabulary::kNone) {
+        if (const float* vector = pretrained.find(id)) {
+            return vector;
+        }
+        if (const float* vector = embeddings.find(id)) {
+            return vector;
         }
-        modelFile << std::endl;  // New line after each response
-
-        std::cout << "Saved response: " << response << " with vector to file." << std::endl;
     }
 
-    sqlite3_finalize(stmt);  // Clean up the prepared statement
-    modelFile.close();  // Close the model file
-    std::cout << "Model saved to " << filename << std::endl;
-}
-std::vector<float> NeuralNet::getTokenVector(const std::string& token) {
-    // First, check in the pre-trained embeddings
-    if (pretrainedEmbeddings.find(token) != pretrainedEmbeddings.end()) {
-        return pretrainedEmbeddings[token];  // Return pre-trained embedding if available
-    }
-
-    // If not in pre-trained embeddings, check the database
-    const char* sql = "SELECT vector FROM word_vectors WHERE word = ?;";
-    sqlite3_stmt* stmt;
-    std::vector<float> vector;
-
-    if (sqlite3_prepare_v2(db.get(), sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, token.c_str(), -1, SQLITE_STATIC);
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            const char* vecData = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            std::string vecString(vecData);
-            std::istringstream vecStream(vecString);
-            float val;
-            while (vecStream >> val) {
-                vector.push_back(val);  // Push each value of the vector into the result
-            }
+    // Then the mapped model file, for words the database has not seen
+    if (model.dimension() == embeddingSize) {
+        if (const float* vector = model.find(ModelFile::Words, token)) {
+            return vector;
         }
-        sqlite3_finalize(stmt);
     }
 
-    // If no vector is found in the database, return a zero vector or a default vector
-    if (vector.empty()) {
+    if (logMiss) {
         std::cout << "No embedding found for word: " << token << ". Returning default vector." << std::endl;
-        return std::vector<float>(embeddingSize, 0.0f);  // Return a zero vector or any default vector
     }
+    return nullptr;
+}
 
-    return vector;
+// Stored words keep the spelling they were imported with ("Hello,"), so fall back to the raw span
+const float* NeuralNet::lookupWord(const Tokenizer::Token& token, bool logMiss) const {
+    if (token.source == token.text) return lookupToken(token.text, logMiss);
+    if (const float* vector = lookupToken(token.text, false)) return vector;
+    return lookupToken(token.source, logMiss);
 }
 
+std::vector<float> NeuralNet::getTokenVector(const std::string& token) {
+    if (const float* vector = lookupToken(token)) {
+        return std::vector<float>(vector, vector + embeddingSize);
+    }
+    return std::vector<float>(embeddingSize, 0.0f);  // Return a zero vector for unknown words
+}
 
 
-void NeuralNet::trainFromDatabase(sqlite3* db) {
-    const char* sql = "SELECT topic, response FROM responses;";  // SQL query to get input-response pairs
-    sqlite3_stmt* stmt;
 
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            std::string input = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));  // Get input (topic)
-            std::string response = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));  // Get response
+// Train on every stored pair. Each epoch shards the pairs across worker threads that read
+// a snapshot of the embeddings; per-shard updates are averaged per key and applied at the end
+// of the epoch, so repeated keys no longer depend on row order.
+void NeuralNet::trainFromDatabase(Database& db, const TrainingConfig& config) {
+    // Load all pairs, interning the distinct input and response strings
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, uint32_t> keyIds;
+    std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    auto keyId = [&](const char* text) {
+        auto [it, inserted] = keyIds.emplace(text, static_cast<uint32_t>(keys.size()));
+        if (inserted) keys.push_back(it->first);
+        return it->second;
+    };
+
+    {
+        auto stmt = db.prepare("SELECT topic, response FROM responses;");  // Input-response pairs
+        if (!stmt) {
+            std::cerr << "Error querying database for training data: " << db.errorMessage() << std::endl;
+            return;
+        }
+        while (stmt.step() == SQLITE_ROW) {
+            const unsigned char* input = sqlite3_column_text(stmt, 0);
+            const unsigned char* response = sqlite3_column_text(stmt, 1);
+            if (!input || !response) continue;
+            pairs.emplace_back(keyId(reinterpret_cast<const char*>(input)), keyId(reinterpret_cast<const char*>(response)));
+        }
+    }
+    if (pairs.empty()) return;
+
+    ThreadPool workers(config.threads);
+    const size_t dim = embeddingSize;
+    const size_t shardCount = std::min(workers.size(), pairs.size());
+
+    // Sparse per-shard sums: only the keys a shard touches get a slot
+    struct Shard {
+        std::unordered_map<uint32_t, uint32_t> slots;
+        std::vector<uint32_t> slotKeys;
+        std::vector<float> sums;
+        std::vector<uint32_t> counts;
+        double loss = 0.0;
+    };
+    std::vector<Shard> shards(shardCount);
+    std::vector<float> sums(keys.size() * dim);
+    std::vector<uint32_t> counts(keys.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int epoch = 1; epoch <= config.epochs; ++epoch) {
+        auto epochStart = std::chrono::steady_clock::now();
+
+        std::vector<std::future<void>> done;
+        for (size_t s = 0; s < shardCount; ++s) {
+            done.push_back(workers.submit([&, s] {
+                Shard& shard = shards[s];
+                shard.slots.clear();
+                shard.slotKeys.clear();
+                shard.sums.clear();
+                shard.counts.clear();
+                shard.loss = 0.0;
+
+                auto add = [&](uint32_t key, const std::vector<float>& vec) {
+                    auto [it, inserted] = shard.slots.emplace(key, static_cast<uint32_t>(shard.slotKeys.size()));
+                    if (inserted) {
+                        shard.slotKeys.push_back(key);
+                        shard.sums.resize(shard.sums.size() + dim, 0.0f);
+                        shard.counts.push_back(0);
+                    }
+                    VectorMath::axpy(1.0f, vec.data(), &shard.sums[it->second * dim], dim);
+                    shard.counts[it->second]++;
+                };
+
+                std::vector<float> inputVec(dim), responseVec(dim);
+                size_t begin = pairs.size() * s / shardCount, end = pairs.size() * (s + 1) / shardCount;
+                for (size_t p = begin; p < end; ++p) {
+                    vectorizeInto(keys[pairs[p].first], inputVec.data(), false);
+                    vectorizeInto(keys[pairs[p].second], responseVec.data(), false);
+
+                    // Same step as train()
+                    auto predictedOutput = forwardPass(inputVec, inputVec);
+                    float loss = computeLoss(predictedOutput, responseVec);
+                    backpropagate(inputVec, responseVec, loss, config.learningRate);
+                    shard.loss += loss;
+
+                    add(pairs[p].first, inputVec);
+                    add(pairs[p].second, responseVec);
+                }
+            }));
+        }
+        for (auto& shardDone : done) shardDone.get();
+
+        // Reduce the shards, then apply the averaged vectors to the resident tables
+        std::fill(sums.begin(), sums.end(), 0.0f);
+        std::fill(counts.begin(), counts.end(), 0);
+        double epochLoss = 0.0;
+        for (const Shard& shard : shards) {
+            for (size_t slot = 0; slot < shard.slotKeys.size(); ++slot) {
+                VectorMath::axpy(1.0f, &shard.sums[slot * dim], &sums[shard.slotKeys[slot] * dim], dim);
+                counts[shard.slotKeys[slot]] += shard.counts[slot];
+            }
+            epochLoss += shard.loss;
+        }
 
-            // Train the model using the input-response pair
-            train(input, response);  // Call the existing train method to update the model's embeddings
+        std::vector<float> vec(dim);
+        for (uint32_t key = 0; key < keys.size(); ++key) {
+            if (counts[key] == 0) continue;
+            for (size_t d = 0; d < dim; ++d) vec[d] = sums[key * dim + d] / counts[key];
+            setTokenVector(keys[key], vec);
         }
-        sqlite3_finalize(stmt);
-    } else {
-        std::cerr << "Error querying database for training data: " << sqlite3_errmsg(db) << std::endl;
+
+        double epochMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - epochStart).count();
+        std::cout << "[NeuralNet] Epoch " << epoch << "/" << config.epochs << ": loss " << epochLoss / pairs.size()
+                  << ", " << epochMs << " ms" << std::endl;
     }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Persist every trained vector in one transaction, after anything already queued
+    flushTokenVectors();
+    size_t written = 0;
+    db.exec("BEGIN;");
+    for (uint32_t key = 0; key < keys.size(); ++key) {
+        const float* trained = embeddings.find(keys[key]);
+        if (!trained) continue;  // Only with epochs == 0
+        auto insert = db.prepare("INSERT OR REPLACE INTO word_vectors (word, vector) VALUES (?, ?);");
+        if (!insert) break;
+        sqlite3_bind_text(insert, 1, keys[key].c_str(), -1, SQLITE_STATIC);
+        VectorCodec::bindVector(insert, 2, std::vector<float>(trained, trained + dim));
+        if (insert.step() == SQLITE_DONE) written++;
+    }
+    db.exec("COMMIT;");
+
+    std::cout << "[NeuralNet] Trained " << pairs.size() << " pairs x " << config.epochs << " epochs on "
+              << workers.size() << " threads in " << seconds << " s (" << config.epochs / std::max(seconds, 1e-9)
+              << " epochs/s); wrote " << written << " vectors in one transaction." << std::endl;
 }
 
 void NeuralNet::loadModelFromFile(const std::string& filename) {
-    std::ifstream inFile(filename);
+    modelChanged();  // Its words back up unknown tokens
+    if (!model.open(filename)) {
+        if (std::ifstream(filename)) {
+            std::cerr << "Model file " << filename << " is not a binary model; convert it with nova_model_tool." << std::endl;
+            return;
+        }
 
-    if (!inFile) {
-        // If the file doesn't exist, notify the user and create an empty file
+        // If the file doesn't exist, notify the user and write one from the current tables
         std::cerr << "Model file does not exist, creating a new one!" << std::endl;
-        
-        // Create the model file and save an empty model
-        saveModelToFile(filename);  // This will create an empty model file if it doesn't exist
-        return;
+        if (!saveModelToFile(filename) || !model.open(filename)) return;
     }
 
-    // If file exists, proceed to load the model
-    std::string word;
-    std::string response;
-    
-    while (inFile >> word) {
-        std::vector<float> vector;
-        float val;
-        while (inFile >> val) {
-            vector.push_back(val);
-        }
-        wordEmbeddings[word] = vector;
+    if (model.dimension() != embeddingSize) {
+        std::cerr << "Model file " << filename << " holds " << model.dimension() << "-dimensional vectors but the database holds "
+                  << embeddingSize << "; its words are not used." << std::endl;
     }
-
-    // Load response embeddings if applicable
-    while (inFile >> response) {
-        std::vector<float> vector;
-        float val;
-        while (inFile >> val) {
-            vector.push_back(val);
-        }
-        responseEmbeddings[response] = vector;
-    }
-
-    inFile.close();
-    std::cout << "Model loaded from " << filename << std::endl;
+    std::cout << "Model mapped from " << filename << " (" << model.size(ModelFile::Words) << " words, "
+              << model.size(ModelFile::Responses) << " responses)." << std::endl;
 }
 
 
 void NeuralNet::updateTokenVector(const std::string& token, const std::vector<float>& vector) {
-    wordEmbeddings[token] = vector;  // Update in memory
-    
-    // Now update the database with the new vector
-    storeTokenVector(token, vector);  // Calls a helper function to store the vector in DB
-}
+    setTokenVector(token, vector);  // Update the resident table vectorize reads
 
-// Cosine similarity function to calculate the similarity between two vectors
-float NeuralNet::cosineSimilarity(const std::vector<float>& vecA, const std::vector<float>& vecB) {
-    float dotProduct = 0.0f;
-    float normA = 0.0f;
-    float normB = 0.0f;
+    // Now queue the new vector for the database
+    storeTokenVector(token, vector);  // Persisted asynchronously by the writer thread
+}
 
-    for (size_t i = 0; i < vecA.size(); ++i) {
-        dotProduct += vecA[i] * vecB[i];
-        normA += vecA[i] * vecA[i];
-        normB += vecB[i] * vecB[i];
+void NeuralNet::setTokenVector(const std::string& token, const std::vector<float>& vector) {
+    modelChanged();
+    uint32_t id = embeddings.set(token, vector);
+    wordIndex.set(id, embeddings.vector(id));
+
+    if (wordAnnEnabled) {
+        wordAnn.insert(token, embeddings.vector(id));
+        annDirty = true;
+    } else if (embeddings.size() >= kAnnThreshold) {
+        buildWordAnn();
+        annDirty = true;
     }
+}
 
-    normA = std::sqrt(normA);
-    normB = std::sqrt(normB);
+std::vector<std::pair<std::string, float>> NeuralNet::topK(const std::vector<float>& queryVec, size_t k) const {
+    // Exact search is sub-millisecond at our size; switch to the graph once the vocabulary outgrows it
+    if (wordAnnEnabled && wordIndex.size() >= kAnnThreshold) {
+        return wordAnn.search(queryVec, k);
+    }
 
-    if (normA == 0 || normB == 0) {
-        return 0.0f;
+    std::vector<std::pair<std::string, float>> words;
+    for (const auto& [id, score] : wordIndex.topK(queryVec, k)) {
+        words.emplace_back(embeddings.word(id), score);
     }
+    return words;
+}
 
-    return dotProduct / (normA * normB);
+// Cosine similarity function to calculate the similarity between two vectors
+float NeuralNet::cosineSimilarity(const std::vector<float>& vecA, const std::vector<float>& vecB) {
+    return VectorMath::cosine(vecA.data(), vecB.data(), std::min(vecA.size(), vecB.size()));
 }
 
 // Compute the loss function (Mean Squared Error)
 float NeuralNet::computeLoss(const std::vector<float>& predicted, const std::vector<float>& actual) {
-    float loss = 0.0f;
-    for (size_t i = 0; i < predicted.size(); ++i) {
-        loss += std::pow(predicted[i] - actual[i], 2);  // Squared difference
-    }
-    return loss / predicted.size();  // Return the mean of squared errors
+    return VectorMath::mse(predicted.data(), actual.data(), predicted.size());  // Mean of squared errors
 }
 
 // Perform forward pass (calculate output using the weights and input)
 std::vector<float> NeuralNet::forwardPass(const std::vector<float>& input, const std::vector<float>& weights) {
     std::vector<float> output(input.size(), 0.0f);
+    VectorMath::mul(input.data(), weights.data(), output.data(), input.size());  // Weighted input, element-wise
+    return output;
+}
 
-    // Element-wise multiplication (dot product)
-    for (size_t i = 0; i < input.size(); ++i) {
-        output[i] = input[i] * weights[i];  // Weighted input
+void NeuralNet::backpropagate(std::vector<float>& weights, const std::vector<float>& target, float loss, float learningRate) {
+    // Gradient descent with the simplified gradient (weights - target) * weights
+    std::vector<float> gradient(weights);
+    VectorMath::axpy(-1.0f, target.data(), gradient.data(), gradient.size());
+    VectorMath::mul(gradient.data(), weights.data(), gradient.data(), gradient.size());
+    VectorMath::axpy(-learningRate, gradient.data(), weights.data(), weights.size());
+}
+
+
+
+// One SGD step on the weights of forwardPass for a single example (gradient of the MSE)
+void NeuralNet::backpropagate(std::vector<float>& weights, const std::vector<float>& input, const std::vector<float>& target, float learningRate) {
+    // d/dw mean((x * w - t)^2) = 2/n * (x * w - t) * x
+    std::vector<float> error(weights.size());
+    VectorMath::mul(input.data(), weights.data(), error.data(), error.size());
+    VectorMath::axpy(-1.0f, target.data(), error.data(), error.size());
+    VectorMath::mul(error.data(), input.data(), error.data(), error.size());
+    VectorMath::axpy(-learningRate * 2.0f / weights.size(), error.data(), weights.data(), weights.size());
+}
+
+float TrainingConfig::learningRateAt(int epoch) const {
+    switch (schedule) {
+    case Schedule::StepDecay:
+        return learningRate * std::pow(decayFactor, decayEvery > 0 ? epoch / decayEvery : 0);
+    case Schedule::Cosine:
+        return learningRate * 0.5f * (1.0f + std::cos(3.14159265f * epoch / std::max(epochs, 1)));
+    default:
+        return learningRate;
     }
-    return output;  // Return the calculated output
 }
 
-void NeuralNet::backpropagate(std::vector<float>& weights, const std::vector<float>& target, float loss, float learningRate) {
-    // Gradient descent: Calculate the gradient (simplified version)
-    for (int i = 0; i < weights.size(); ++i) {
-        // Compute the gradient: (predicted - target) * input for each weight
-        float gradient = (weights[i] - target[i]) * weights[i]; // Simplified gradient calculation
-        weights[i] -= learningRate * gradient; // Update the weight with the gradient descent step
+void NeuralNet::trainNetwork(std::vector<std::vector<float>>& inputs, std::vector<std::vector<float>>& targets, std::vector<float>& weights, float learningRate, int epochs) {
+    if (inputs.empty() || inputs.size() != targets.size()) return;
+
+    Tensor inputTensor(inputs.size(), inputs[0].size()), targetTensor(targets.size(), inputs[0].size());
+    for (size_t r = 0; r < inputs.size(); ++r) {
+        std::copy_n(inputs[r].begin(), std::min(inputs[r].size(), inputTensor.cols), inputTensor.row(r));
+        std::copy_n(targets[r].begin(), std::min(targets[r].size(), targetTensor.cols), targetTensor.row(r));
+    }
+
+    TrainingConfig config;
+    config.learningRate = learningRate;
+    config.epochs = epochs;
+    trainNetwork(inputTensor, targetTensor, weights, config);
+}
+
+// Minibatch gradient descent on the element-wise weights of forwardPass
+std::vector<float> NeuralNet::trainNetwork(const Tensor& inputs, const Tensor& targets, std::vector<float>& weights, const TrainingConfig& config) {
+    std::vector<float> lossCurve;
+    if (inputs.rows == 0 || inputs.rows != targets.rows || inputs.cols != targets.cols) {
+        std::cerr << "trainNetwork: inputs and targets must have the same non-empty shape." << std::endl;
+        return lossCurve;
+    }
+
+    const size_t rows = inputs.rows, cols = inputs.cols;
+    const size_t batchSize = std::max<size_t>(1, std::min(config.batchSize, rows));
+    if (weights.size() != cols) weights.assign(cols, 1.0f);  // Start from the identity
+
+    std::vector<size_t> order(rows);
+    for (size_t r = 0; r < rows; ++r) order[r] = r;
+    std::mt19937 rng(config.seed);
+
+    Tensor batchInputs(batchSize, cols), batchTargets(batchSize, cols), batchErrors(batchSize, cols);
+    std::vector<float> gradient(cols);
+    std::vector<float> bestWeights = weights;
+    float bestLoss = std::numeric_limits<float>::max();
+    int epochsSinceBest = 0;
+    bool stoppedEarly = false;
+
+    for (int epoch = 0; epoch < config.epochs; ++epoch) {
+        auto start = std::chrono::steady_clock::now();
+        if (config.shuffle) std::shuffle(order.begin(), order.end(), rng);
+        const float rate = config.learningRateAt(epoch);
+        double epochLoss = 0.0;
+
+        for (size_t begin = 0; begin < rows; begin += batchSize) {
+            const size_t count = std::min(batchSize, rows - begin);
+
+            // Gather the (shuffled) minibatch into contiguous buffers
+            for (size_t b = 0; b < count; ++b) {
+                std::copy_n(inputs.row(order[begin + b]), cols, batchInputs.row(b));
+                std::copy_n(targets.row(order[begin + b]), cols, batchTargets.row(b));
+            }
+
+            // errors = x * w - t for the whole batch, then gradient = sum over rows of errors * x
+            std::fill(gradient.begin(), gradient.end(), 0.0f);
+            for (size_t b = 0; b < count; ++b) {
+                VectorMath::mul(batchInputs.row(b), weights.data(), batchErrors.row(b), cols);
+            }
+            VectorMath::axpy(-1.0f, batchTargets.data.data(), batchErrors.data.data(), count * cols);
+            epochLoss += VectorMath::dot(batchErrors.data.data(), batchErrors.data.data(), count * cols);
+            VectorMath::mul(batchErrors.data.data(), batchInputs.data.data(), batchErrors.data.data(), count * cols);
+            for (size_t b = 0; b < count; ++b) {
+                VectorMath::axpy(1.0f, batchErrors.row(b), gradient.data(), cols);
+            }
+
+            VectorMath::axpy(-rate * 2.0f / static_cast<float>(count * cols), gradient.data(), weights.data(), cols);
+        }
+
+        float loss = static_cast<float>(epochLoss / (rows * cols));
+        lossCurve.push_back(loss);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "[NeuralNet] trainNetwork epoch " << epoch + 1 << "/" << config.epochs << ": loss " << loss
+                  << ", lr " << rate << ", " << ms << " ms" << std::endl;
+
+        if (loss < bestLoss - config.minImprovement) {
+            bestLoss = loss;
+            bestWeights = weights;
+            epochsSinceBest = 0;
+        } else if (config.patience > 0 && ++epochsSinceBest >= config.patience) {
+            std::cout << "[NeuralNet] Early stop: no improvement for " << config.patience << " epochs (best loss "
+                      << bestLoss << ")." << std::endl;
+            stoppedEarly = true;
+            break;
+        }
     }
+
+    if (stoppedEarly) weights = bestWeights;
+    return lossCurve;
 }
 
+// Fits forwardPass weights on the vectorized responses table; returns the loss curve
+std::vector<float> NeuralNet::trainOnResponses(Database& db, const TrainingConfig& config, std::vector<float>& weights) {
+    std::vector<std::pair<std::string, std::string>> pairs;
+    {
+        auto stmt = db.prepare("SELECT topic, response FROM responses;");
+        if (!stmt) return {};
+        while (stmt.step() == SQLITE_ROW) {
+            const unsigned char* input = sqlite3_column_text(stmt, 0);
+            const unsigned char* response = sqlite3_column_text(stmt, 1);
+            if (input && response) {
+                pairs.emplace_back(reinterpret_cast<const char*>(input), reinterpret_cast<const char*>(response));
+            }
+        }
+    }
+    if (pairs.empty()) return {};
 
+    Tensor inputs(pairs.size(), embeddingSize), targets(pairs.size(), embeddingSize);
+    for (size_t r = 0; r < pairs.size(); ++r) {
+        vectorizeInto(pairs[r].first, inputs.row(r), false);
+        vectorizeInto(pairs[r].second, targets.row(r), false);
+    }
+
+    return trainNetwork(inputs, targets, weights, config);
+}
 
 void NeuralNet::train(const std::string& input, const std::string& response) {
+    float loss = trainStep(input, response);
+    std::cout << "Initial Loss: " << loss << std::endl;
+    std::cout << "Training completed for input: " << input << " and response: " << response << std::endl;
+}
+
+float NeuralNet::trainStep(const std::string& input, const std::string& response) {
     // Vectorize the input and response to get their corresponding embeddings
     auto inputVec = vectorize(input);
     auto responseVec = vectorize(response);
 
-    // Store initial embeddings of the response
-    responseEmbeddings[response] = responseVec;
-
     // Forward pass: get the predicted output for the input
     auto predictedOutput = forwardPass(inputVec, inputVec);  // You may need to adjust weights here
 
     // Compute the loss based on predicted output and expected response embedding
     float loss = computeLoss(predictedOutput, responseVec);
-    std::cout << "Initial Loss: " << loss << std::endl;
 
     backpropagate(inputVec, responseVec, loss, 0.01f);  // Example with learning rate = 0.01
 
-    // Update response embeddings (we'll update after training)
-    responseEmbeddings[response] = responseVec;  // Store updated embedding
+    // Store the new word embeddings; the writer thread persists them
+    updateTokenVector(input, inputVec);
+    updateTokenVector(response, responseVec);
+    return loss;
+}
+
+// Train on many pairs in order without per-pair logging, then wait for the writes
+void NeuralNet::trainBatch(const std::vector<std::pair<std::string, std::string>>& pairs) {
+    if (pairs.empty()) return;
 
-    // Optionally, you can store the new word embeddings back into the database
-    updateTokenVector(input, inputVec);  // Update input vector in the DB
-    updateTokenVector(response, responseVec);  // Update response vector in the DB
+    auto start = std::chrono::steady_clock::now();
+    double totalLoss = 0.0;
+    for (const auto& [input, response] : pairs) {
+        totalLoss += trainStep(input, response);
+    }
+    flushTokenVectors();
 
-    std::cout << "Training completed for input: " << input << " and response: " << response << std::endl;
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "[NeuralNet] Trained " << pairs.size() << " pairs in " << seconds << " s ("
+              << pairs.size() / std::max(seconds, 1e-9) << " pairs/s, mean loss "
+              << totalLoss / pairs.size() << ")." << std::endl;
 }
\ No newline at end of file
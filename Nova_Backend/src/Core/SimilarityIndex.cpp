@@ -0,0 +1,102 @@
+#include "../../include/Core/SimilarityIndex.hpp"
+#include "../../include/Core/EmbeddingStore.hpp"
+#include "../../include/Core/VectorMath.hpp"
+#include <algorithm>
+#include <queue>
+
+namespace {
+    thread_local std::vector<float> scores;  // Scratch buffer reused across queries on this thread
+}
+
+SimilarityIndex::SimilarityIndex(int dimension) : dim(dimension) {}
+
+void SimilarityIndex::clear() {
+    count = 0;
+    capacity = 0;
+    columns.clear();
+}
+
+void SimilarityIndex::reserve(size_t rows) {
+    if (rows <= capacity) return;
+
+    size_t newCapacity = std::max<size_t>({rows, capacity * 2, 64});
+    std::vector<float> grown(newCapacity * dim, 0.0f);
+    for (int d = 0; d < dim; ++d) {
+        std::copy(columns.begin() + d * capacity, columns.begin() + d * capacity + count,
+                  grown.begin() + d * newCapacity);
+    }
+    columns.swap(grown);
+    capacity = newCapacity;
+}
+
+void SimilarityIndex::build(const EmbeddingStore& store) {
+    clear();
+    reserve(store.size());
+    for (uint32_t id = 0; id < store.size(); ++id) {
+        set(id, store.vector(id));
+    }
+}
+
+void SimilarityIndex::set(uint32_t id, const float* vector) {
+    if (id >= count) {
+        reserve(static_cast<size_t>(id) + 1);
+        count = static_cast<size_t>(id) + 1;
+    }
+
+    float norm = VectorMath::norm(vector, dim);
+
+    // Zero vectors stay zero and score 0 against everything
+    float scale = norm > 0.0f ? 1.0f / norm : 0.0f;
+    for (int d = 0; d < dim; ++d) {
+        columns[d * capacity + id] = vector[d] * scale;
+    }
+}
+
+void SimilarityIndex::score(const std::vector<float>& query, std::vector<float>& out) const {
+    // out = sum_d q[d] * column_d
+    out.assign(count, 0.0f);
+    if (query.size() < static_cast<size_t>(dim)) return;
+    for (int d = 0; d < dim; ++d) {
+        VectorMath::axpy(query[d], columns.data() + d * capacity, out.data(), count);
+    }
+}
+
+std::vector<std::pair<uint32_t, float>> SimilarityIndex::topK(const std::vector<float>& query, size_t k) const {
+    std::vector<std::pair<uint32_t, float>> result;
+    if (count == 0 || k == 0 || query.size() < static_cast<size_t>(dim)) return result;
+
+    float norm = VectorMath::norm(query.data(), dim);
+    if (norm == 0.0f) return result;  // A zero query has no meaningful neighbours
+
+    // Score every row against the normalized query
+    std::vector<float> unit(query.begin(), query.begin() + dim);
+    for (float& v : unit) v /= norm;
+    score(unit, scores);
+
+    if (k == 1) {
+        size_t best = std::max_element(scores.begin(), scores.end()) - scores.begin();
+        result.emplace_back(static_cast<uint32_t>(best), scores[best]);
+        return result;
+    }
+
+    // Bounded min-heap holding the best k seen so far
+    auto worse = [](const std::pair<uint32_t, float>& a, const std::pair<uint32_t, float>& b) {
+        return a.second > b.second || (a.second == b.second && a.first < b.first);
+    };
+    std::priority_queue<std::pair<uint32_t, float>, std::vector<std::pair<uint32_t, float>>, decltype(worse)> heap(worse);
+    for (size_t i = 0; i < count; ++i) {
+        if (heap.size() < k) {
+            heap.emplace(static_cast<uint32_t>(i), scores[i]);
+        } else if (scores[i] > heap.top().second) {
+            heap.pop();
+            heap.emplace(static_cast<uint32_t>(i), scores[i]);
+        }
+    }
+
+    result.resize(heap.size());
+    for (size_t i = result.size(); i-- > 0;) {
+        result[i] = heap.top();
+        heap.pop();
+    }
+    return result;
+}
@@ -0,0 +1,78 @@
+#include "../../include/Core/Tokenizer.hpp"
+#include <algorithm>
+
+namespace {
+    bool isSpace(unsigned char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    bool isAsciiPunct(unsigned char c) {
+        return (c >= '!' && c <= '/') || (c >= ':' && c <= '@') || (c >= '[' && c <= '`') || (c >= '{' && c <= '~');
+    }
+
+    // Length of the UTF-8 sequence starting with `lead` (1 for a stray continuation byte)
+    size_t sequenceLength(unsigned char lead) {
+        if (lead >= 0xF0) return 4;
+        if (lead >= 0xE0) return 3;
+        if (lead >= 0xC0) return 2;
+        return 1;
+    }
+
+    // U+2013/2014 dashes, U+2018/2019/201C/201D quotes and U+2026 ellipsis: E2 80 xx
+    bool isUnicodePunct(const unsigned char* s, size_t n) {
+        if (n != 3 || s[0] != 0xE2 || s[1] != 0x80) return false;
+        unsigned char c = s[2];
+        return c == 0x93 || c == 0x94 || c == 0x98 || c == 0x99 || c == 0x9C || c == 0x9D || c == 0xA6;
+    }
+
+    // Appends the normalized form of word to out; returns the number of bytes added
+    size_t appendNormalized(std::string_view word, std::string& out) {
+        size_t before = out.size();
+        const auto* s = reinterpret_cast<const unsigned char*>(word.data());
+        for (size_t i = 0; i < word.size();) {
+            unsigned char c = s[i];
+            if (c < 0x80) {
+                if (!isAsciiPunct(c)) out += static_cast<char>(c >= 'A' && c <= 'Z' ? c + ('a' - 'A') : c);
+                ++i;
+                continue;
+            }
+            size_t n = std::min(sequenceLength(c), word.size() - i);
+            if (!isUnicodePunct(s + i, n)) out.append(word.data() + i, n);
+            i += n;
+        }
+        return out.size() - before;
+    }
+}
+
+const std::vector<Tokenizer::Token>& Tokenizer::tokenize(std::string_view input) {
+    // Normalized text is never longer than the input, so the views below stay put
+    buffer.clear();
+    if (buffer.capacity() < input.size()) buffer.reserve(input.size());
+    list.clear();
+
+    size_t i = 0;
+    while (i < input.size()) {
+        while (i < input.size() && isSpace(static_cast<unsigned char>(input[i]))) ++i;
+        size_t start = i;
+        while (i < input.size() && !isSpace(static_cast<unsigned char>(input[i]))) ++i;
+        if (i == start) break;
+
+        std::string_view word = input.substr(start, i - start);
+        size_t offset = buffer.size();
+        size_t length = appendNormalized(word, buffer);
+        if (length > 0) list.push_back({std::string_view(buffer.data() + offset, length), word});
+    }
+    return list;
+}
+
+Tokenizer& Tokenizer::local() {
+    thread_local Tokenizer tokenizer;
+    return tokenizer;
+}
+
+std::string Tokenizer::normalize(std::string_view word) {
+    std::string out;
+    out.reserve(word.size());
+    appendNormalized(word, out);
+    return out;
+}
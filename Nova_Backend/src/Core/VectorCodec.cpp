@@ -0,0 +1,228 @@
+#include "../../include/Core/VectorCodec.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+// The encoding is little-endian; values are copied with memcpy, which matches
+// the byte order of every platform we build for (x86-64 and ARM64).
+
+std::vector<unsigned char> VectorCodec::encode(const std::vector<float>& values, Encoding encoding) {
+    const size_t dim = std::min<size_t>(values.size(), 0xFFFF);
+    size_t payload = dim * sizeof(float);
+    if (encoding == Encoding::Float16) payload = dim * sizeof(uint16_t);
+    if (encoding == Encoding::Int8) payload = sizeof(float) + dim;
+
+    std::vector<unsigned char> out(kHeaderSize + payload, 0);
+    out[0] = 'N';
+    out[1] = 'V';
+    out[2] = kVersion;
+    out[3] = static_cast<uint8_t>(encoding);
+    out[4] = static_cast<uint8_t>(dim & 0xFF);
+    out[5] = static_cast<uint8_t>(dim >> 8);
+
+    unsigned char* body = out.data() + kHeaderSize;
+    switch (encoding) {
+        case Encoding::Float32:
+            std::memcpy(body, values.data(), dim * sizeof(float));
+            break;
+        case Encoding::Float16:
+            for (size_t i = 0; i < dim; ++i) {
+                uint16_t half = floatToHalf(values[i]);
+                std::memcpy(body + i * sizeof(uint16_t), &half, sizeof(half));
+            }
+            break;
+        case Encoding::Int8: {
+            float maxAbs = 0.0f;
+            for (size_t i = 0; i < dim; ++i) maxAbs = std::max(maxAbs, std::fabs(values[i]));
+            float scale = maxAbs > 0.0f ? maxAbs / 127.0f : 1.0f;
+            std::memcpy(body, &scale, sizeof(scale));
+            for (size_t i = 0; i < dim; ++i) {
+                long q = std::lround(values[i] / scale);
+                body[sizeof(float) + i] = static_cast<unsigned char>(static_cast<int8_t>(std::clamp(q, -127L, 127L)));
+            }
+            break;
+        }
+    }
+    return out;
+}
+
+bool VectorCodec::isBinary(const void* data, size_t size) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    return size >= kHeaderSize && bytes[0] == 'N' && bytes[1] == 'V' && bytes[2] == kVersion;
+}
+
+bool VectorCodec::decode(const void* data, size_t size, std::vector<float>& out) {
+    out.clear();
+    if (!data || size == 0) return false;
+    if (!isBinary(data, size)) {
+        return parseText(static_cast<const char*>(data), size, out);
+    }
+
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    const auto encoding = static_cast<Encoding>(bytes[3]);
+    const size_t dim = bytes[4] | (static_cast<size_t>(bytes[5]) << 8);
+    const unsigned char* body = bytes + kHeaderSize;
+    const size_t bodySize = size - kHeaderSize;
+
+    switch (encoding) {
+        case Encoding::Float32:
+            if (bodySize < dim * sizeof(float)) return false;
+            out.resize(dim);
+            std::memcpy(out.data(), body, dim * sizeof(float));
+            return true;
+        case Encoding::Float16:
+            if (bodySize < dim * sizeof(uint16_t)) return false;
+            out.resize(dim);
+            for (size_t i = 0; i < dim; ++i) {
+                uint16_t half;
+                std::memcpy(&half, body + i * sizeof(uint16_t), sizeof(half));
+                out[i] = halfToFloat(half);
+            }
+            return true;
+        case Encoding::Int8: {
+            if (bodySize < sizeof(float) + dim) return false;
+            float scale;
+            std::memcpy(&scale, body, sizeof(scale));
+            out.resize(dim);
+            for (size_t i = 0; i < dim; ++i) {
+                out[i] = static_cast<int8_t>(body[sizeof(float) + i]) * scale;
+            }
+            return true;
+        }
+    }
+    return false;  // Unknown encoding
+}
+
+bool VectorCodec::readColumn(sqlite3_stmt* stmt, int col, std::vector<float>& out) {
+    switch (sqlite3_column_type(stmt, col)) {
+        case SQLITE_BLOB: {
+            const void* blob = sqlite3_column_blob(stmt, col);
+            return decode(blob, static_cast<size_t>(sqlite3_column_bytes(stmt, col)), out);
+        }
+        case SQLITE_TEXT: {
+            const unsigned char* text = sqlite3_column_text(stmt, col);
+            return decode(text, static_cast<size_t>(sqlite3_column_bytes(stmt, col)), out);
+        }
+        default:
+            out.clear();
+            return false;
+    }
+}
+
+void VectorCodec::bindVector(sqlite3_stmt* stmt, int index, const std::vector<float>& values, Encoding encoding) {
+    auto blob = encode(values, encoding);
+    sqlite3_bind_blob(stmt, index, blob.data(), static_cast<int>(blob.size()), SQLITE_TRANSIENT);
+}
+
+int VectorCodec::migrateTextRows(sqlite3* db, Encoding encoding) {
+    sqlite3_stmt* select;
+    if (sqlite3_prepare_v2(db, "SELECT rowid, vector FROM word_vectors WHERE typeof(vector) = 'text';",
+                           -1, &select, nullptr) != SQLITE_OK) {
+        std::cerr << "[VectorCodec] Migration query failed: " << sqlite3_errmsg(db) << std::endl;
+        return 0;
+    }
+
+    sqlite3_stmt* update;
+    if (sqlite3_prepare_v2(db, "UPDATE word_vectors SET vector = ? WHERE rowid = ?;", -1, &update, nullptr) != SQLITE_OK) {
+        std::cerr << "[VectorCodec] Migration update failed: " << sqlite3_errmsg(db) << std::endl;
+        sqlite3_finalize(select);
+        return 0;
+    }
+
+    // Read everything first so the UPDATEs don't disturb the running SELECT
+    std::vector<std::pair<sqlite3_int64, std::vector<float>>> rows;
+    std::vector<float> values;
+    while (sqlite3_step(select) == SQLITE_ROW) {
+        if (readColumn(select, 1, values) && !values.empty()) {
+            rows.emplace_back(sqlite3_column_int64(select, 0), values);
+        }
+    }
+    sqlite3_finalize(select);
+
+    int converted = 0;
+    if (!rows.empty()) {
+        sqlite3_exec(db, "BEGIN;", nullptr, nullptr, nullptr);
+        for (const auto& [rowid, vector] : rows) {
+            bindVector(update, 1, vector, encoding);
+            sqlite3_bind_int64(update, 2, rowid);
+            if (sqlite3_step(update) == SQLITE_DONE) ++converted;
+            sqlite3_reset(update);
+        }
+        sqlite3_exec(db, "COMMIT;", nullptr, nullptr, nullptr);
+        std::cout << "[VectorCodec] Converted " << converted << " text vectors to binary." << std::endl;
+    }
+    sqlite3_finalize(update);
+    return converted;
+}
+
+bool VectorCodec::parseText(const char* text, size_t size, std::vector<float>& out) {
+    std::string buffer(text, size);  // Column text isn't guaranteed to stop at `size`
+    const char* p = buffer.c_str();
+    while (*p) {
+        while (*p == ' ' || *p == ',' || *p == '\t') ++p;
+        if (!*p) break;
+        char* end = nullptr;
+        float value = std::strtof(p, &end);
+        if (end == p) break;  // Not a number
+        out.push_back(value);
+        p = end;
+    }
+    return !out.empty();
+}
+
+uint16_t VectorCodec::floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    int32_t exponent = static_cast<int32_t>((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    if (((bits >> 23) & 0xFF) == 0xFF) {  // Inf / NaN
+        return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+    }
+    if (exponent >= 0x1F) return sign | 0x7C00;  // Overflow to infinity
+    if (exponent <= 0) {                          // Subnormal or zero
+        if (exponent < -10) return sign;
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint16_t half = static_cast<uint16_t>(mantissa >> shift);
+        if ((mantissa >> (shift - 1)) & 1) ++half;  // Round half up
+        return sign | half;
+    }
+
+    uint16_t half = sign | static_cast<uint16_t>(exponent << 10) | static_cast<uint16_t>(mantissa >> 13);
+    if (mantissa & 0x1000) ++half;  // Round half up; carries into the exponent correctly
+    return half;
+}
+
+float VectorCodec::halfToFloat(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+    uint32_t bits;
+
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {  // Subnormal: renormalize
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    } else if (exponent == 0x1F) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
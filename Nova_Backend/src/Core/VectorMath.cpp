@@ -0,0 +1,304 @@
+#include "../../include/Core/VectorMath.hpp"
+#include <atomic>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NOVA_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX2/SSE4 instructions inside functions that ask for them,
+// which keeps the rest of the build runnable on older CPUs
+#if defined(NOVA_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NOVA_TARGET(features) __attribute__((target(features)))
+#else
+#define NOVA_TARGET(features)
+#endif
+
+namespace {
+
+struct Kernels {
+    VectorMath::Isa isa;
+    float (*dot)(const float*, const float*, size_t);
+    float (*squaredDistance)(const float*, const float*, size_t);
+    void (*axpy)(float, const float*, float*, size_t);
+    void (*mul)(const float*, const float*, float*, size_t);
+};
+
+// Scalar reference implementations
+
+float dotScalar(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+float squaredDistanceScalar(const float* a, const float* b, size_t n) {
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        float diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+void axpyScalar(float alpha, const float* x, float* y, size_t n) {
+    for (size_t i = 0; i < n; ++i) y[i] += alpha * x[i];
+}
+
+void mulScalar(const float* a, const float* b, float* out, size_t n) {
+    for (size_t i = 0; i < n; ++i) out[i] = a[i] * b[i];
+}
+
+const Kernels scalarKernels = {VectorMath::Isa::Scalar, dotScalar, squaredDistanceScalar, axpyScalar, mulScalar};
+
+#if defined(NOVA_X86)
+
+// SSE4.1
+
+NOVA_TARGET("sse4.1") float horizontalSum128(__m128 v) {
+    __m128 shuffled = _mm_movehdup_ps(v);
+    __m128 sums = _mm_add_ps(v, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sums);
+    return _mm_cvtss_f32(_mm_add_ss(sums, shuffled));
+}
+
+NOVA_TARGET("sse4.1") float dotSse(const float* a, const float* b, size_t n) {
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    if (i + 4 <= n) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        i += 4;
+    }
+    float sum = horizontalSum128(_mm_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+NOVA_TARGET("sse4.1") float squaredDistanceSse(const float* a, const float* b, size_t n) {
+    __m128 acc = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 diff = _mm_sub_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i));
+        acc = _mm_add_ps(acc, _mm_mul_ps(diff, diff));
+    }
+    float sum = horizontalSum128(acc);
+    for (; i < n; ++i) {
+        float diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+NOVA_TARGET("sse4.1") void axpySse(float alpha, const float* x, float* y, size_t n) {
+    const __m128 scale = _mm_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(scale, _mm_loadu_ps(x + i))));
+    }
+    for (; i < n; ++i) y[i] += alpha * x[i];
+}
+
+NOVA_TARGET("sse4.1") void mulSse(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+    }
+    for (; i < n; ++i) out[i] = a[i] * b[i];
+}
+
+const Kernels sseKernels = {VectorMath::Isa::SSE4, dotSse, squaredDistanceSse, axpySse, mulSse};
+
+// AVX2 + FMA
+
+NOVA_TARGET("avx2,fma") float horizontalSum256(__m256 v) {
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+    __m128 shuffled = _mm_movehdup_ps(sum);
+    sum = _mm_add_ps(sum, shuffled);
+    shuffled = _mm_movehl_ps(shuffled, sum);
+    return _mm_cvtss_f32(_mm_add_ss(sum, shuffled));
+}
+
+NOVA_TARGET("avx2,fma") float dotAvx2(const float* a, const float* b, size_t n) {
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    if (i + 8 <= n) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        i += 8;
+    }
+    float sum = horizontalSum256(_mm256_add_ps(acc0, acc1));
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+NOVA_TARGET("avx2,fma") float squaredDistanceAvx2(const float* a, const float* b, size_t n) {
+    __m256 acc = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+        acc = _mm256_fmadd_ps(diff, diff, acc);
+    }
+    float sum = horizontalSum256(acc);
+    for (; i < n; ++i) {
+        float diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
+
+NOVA_TARGET("avx2,fma") void axpyAvx2(float alpha, const float* x, float* y, size_t n) {
+    const __m256 scale = _mm256_set1_ps(alpha);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(y + i, _mm256_fmadd_ps(scale, _mm256_loadu_ps(x + i), _mm256_loadu_ps(y + i)));
+    }
+    for (; i < n; ++i) y[i] += alpha * x[i];
+}
+
+NOVA_TARGET("avx2,fma") void mulAvx2(const float* a, const float* b, float* out, size_t n) {
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm256_storeu_ps(out + i, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+    }
+    for (; i < n; ++i) out[i] = a[i] * b[i];
+}
+
+const Kernels avx2Kernels = {VectorMath::Isa::AVX2, dotAvx2, squaredDistanceAvx2, axpyAvx2, mulAvx2};
+
+#endif  // NOVA_X86
+
+struct CpuFeatures {
+    bool sse41 = false;
+    bool avx2 = false;  // Also requires FMA and OS support for the YMM registers
+};
+
+CpuFeatures detectCpu() {
+    CpuFeatures features;
+#if defined(NOVA_X86) && defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    features.sse41 = (info[2] & (1 << 19)) != 0;
+    bool fma = (info[2] & (1 << 12)) != 0;
+    bool osAvx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+    __cpuidex(info, 7, 0);
+    features.avx2 = fma && osAvx && (info[1] & (1 << 5));
+#elif defined(NOVA_X86)
+    __builtin_cpu_init();
+    features.sse41 = __builtin_cpu_supports("sse4.1");
+    features.avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+    return features;
+}
+
+const Kernels& kernelsFor(VectorMath::Isa isa) {
+#if defined(NOVA_X86)
+    if (isa == VectorMath::Isa::AVX2) return avx2Kernels;
+    if (isa == VectorMath::Isa::SSE4) return sseKernels;
+#endif
+    (void)isa;
+    return scalarKernels;
+}
+
+std::atomic<const Kernels*> selected{nullptr};
+
+// Below this length the indirect call and the SIMD setup and horizontal sum cost
+// more than the arithmetic: at n = 3 cosine took 59 ns with AVX2 against 21 ns
+// scalar. Shorter vectors run the scalar loops, which inline here.
+const size_t kScalarBelow = 8;
+
+const Kernels& kernels() {
+    const Kernels* active = selected.load(std::memory_order_acquire);
+    if (!active) {
+        CpuFeatures cpu = detectCpu();
+        VectorMath::Isa best = cpu.avx2 ? VectorMath::Isa::AVX2 : cpu.sse41 ? VectorMath::Isa::SSE4 : VectorMath::Isa::Scalar;
+        active = &kernelsFor(best);
+        selected.store(active, std::memory_order_release);
+    }
+    return *active;
+}
+
+}  // namespace
+
+float VectorMath::dot(const float* a, const float* b, size_t n) {
+    if (n < kScalarBelow) return dotScalar(a, b, n);
+    return kernels().dot(a, b, n);
+}
+
+float VectorMath::norm(const float* a, size_t n) {
+    if (n < kScalarBelow) return std::sqrt(dotScalar(a, a, n));
+    return std::sqrt(kernels().dot(a, a, n));
+}
+
+float VectorMath::cosine(const float* a, const float* b, size_t n) {
+    float normA, normB, ab;
+    if (n < kScalarBelow) {
+        // One pass for all three sums
+        normA = normB = ab = 0.0f;
+        for (size_t i = 0; i < n; ++i) {
+            normA += a[i] * a[i];
+            normB += b[i] * b[i];
+            ab += a[i] * b[i];
+        }
+    } else {
+        const Kernels& k = kernels();
+        normA = k.dot(a, a, n);
+        normB = k.dot(b, b, n);
+        ab = k.dot(a, b, n);
+    }
+    if (normA == 0.0f || normB == 0.0f) return 0.0f;
+    return ab / (std::sqrt(normA) * std::sqrt(normB));
+}
+
+void VectorMath::axpy(float alpha, const float* x, float* y, size_t n) {
+    if (n < kScalarBelow) return axpyScalar(alpha, x, y, n);
+    kernels().axpy(alpha, x, y, n);
+}
+
+void VectorMath::mul(const float* a, const float* b, float* out, size_t n) {
+    if (n < kScalarBelow) return mulScalar(a, b, out, n);
+    kernels().mul(a, b, out, n);
+}
+
+float VectorMath::mse(const float* a, const float* b, size_t n) {
+    if (n == 0) return 0.0f;
+    if (n < kScalarBelow) return squaredDistanceScalar(a, b, n) / n;
+    return kernels().squaredDistance(a, b, n) / n;
+}
+
+VectorMath::Isa VectorMath::isa() {
+    return kernels().isa;
+}
+
+bool VectorMath::supports(Isa isa) {
+    CpuFeatures cpu = detectCpu();
+    switch (isa) {
+    case Isa::AVX2: return cpu.avx2;
+    case Isa::SSE4: return cpu.sse41;
+    default: return true;
+    }
+}
+
+bool VectorMath::setIsa(Isa isa) {
+    if (!supports(isa)) return false;
+    selected.store(&kernelsFor(isa), std::memory_order_release);
+    return true;
+}
+
+const char* VectorMath::name(Isa isa) {
+    switch (isa) {
+    case Isa::AVX2: return "avx2+fma";
+    case Isa::SSE4: return "sse4.1";
+    default: return "scalar";
+    }
+}
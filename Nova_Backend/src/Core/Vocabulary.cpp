@@ -0,0 +1,156 @@
+#include "../../include/Core/Vocabulary.hpp"
+#include <cstring>
+#include <functional>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+    const size_t kInitialSlots = 1024;
+    const size_t kBlockBytes = 64 * 1024;
+    const size_t kRecordAlign = alignof(uint32_t);
+
+    int highestBit(uint32_t value) {  // value > 0
+#if defined(_MSC_VER)
+        unsigned long index;
+        _BitScanReverse(&index, value);
+        return static_cast<int>(index);
+#else
+        return 31 - __builtin_clz(value);
+#endif
+    }
+
+    size_t hashOf(std::string_view word) {
+        return std::hash<std::string_view>()(word);
+    }
+}
+
+Vocabulary& Vocabulary::global() {
+    static Vocabulary vocabulary;
+    return vocabulary;
+}
+
+Vocabulary::Vocabulary() {
+    rehash(kInitialSlots);
+}
+
+Vocabulary::~Vocabulary() {
+    for (auto& segment : segments) delete[] segment.load(std::memory_order_relaxed);
+}
+
+// Segment k holds kFirstSegment << k records, starting at id kFirstSegment * (2^k - 1)
+const char* Vocabulary::record(Id id) const {
+    uint32_t quotient = id / kFirstSegment + 1;
+    int segment = highestBit(quotient);
+    size_t offset = id - kFirstSegment * ((size_t(1) << segment) - 1);
+    return segments[segment].load(std::memory_order_acquire)[offset];
+}
+
+Vocabulary::Id Vocabulary::find(std::string_view word) const {
+    size_t hash = hashOf(word);
+    const Table* current = table.load(std::memory_order_acquire);
+    for (size_t i = hash & current->mask;; i = (i + 1) & current->mask) {
+        uint32_t slot = current->slots[i].load(std::memory_order_acquire);
+        if (slot == 0) return kNone;
+        const char* candidate = record(slot - 1);
+        Header header;
+        std::memcpy(&header, candidate, sizeof(header));
+        if (header.hash == static_cast<uint32_t>(hash) && header.length == word.size() &&
+            std::memcmp(candidate + sizeof(Header), word.data(), word.size()) == 0) {
+            return slot - 1;
+        }
+    }
+}
+
+std::string_view Vocabulary::word(Id id) const {
+    const char* stored = record(id);
+    Header header;
+    std::memcpy(&header, stored, sizeof(header));
+    return std::string_view(stored + sizeof(Header), header.length);
+}
+
+Vocabulary::Id Vocabulary::intern(std::string_view word) {
+    Id id = find(word);
+    if (id != kNone) return id;
+
+    std::lock_guard<std::mutex> lock(writeMutex);
+    id = find(word);  // Another writer may have added it
+    if (id != kNone) return id;
+
+    id = static_cast<Id>(count.load(std::memory_order_relaxed));
+    int segment = highestBit(id / kFirstSegment + 1);
+    const char** records = segments[segment].load(std::memory_order_relaxed);
+    if (!records) {
+        records = new const char*[kFirstSegment << segment];
+        segments[segment].store(records, std::memory_order_release);
+    }
+    size_t hash = hashOf(word);
+    records[id - kFirstSegment * ((size_t(1) << segment) - 1)] = store(word, static_cast<uint32_t>(hash));
+
+    // Keep the table at most three quarters full
+    Table* current = table.load(std::memory_order_relaxed);
+    if ((static_cast<size_t>(id) + 1) * 4 > (current->mask + 1) * 3) {
+        rehash((current->mask + 1) * 2);
+        current = table.load(std::memory_order_relaxed);
+    }
+    place(*current, hash, id);  // Publishes the record written above
+    count.store(static_cast<size_t>(id) + 1, std::memory_order_release);
+    return id;
+}
+
+// Appends the word's record to the current block; long words get a block of their own
+const char* Vocabulary::store(std::string_view word, uint32_t hash) {
+    size_t size = sizeof(Header) + word.size();
+    char* data;
+    if (size > kBlockBytes / 4) {
+        blocks.emplace_back(new char[size]);
+        blockBytes += size;
+        data = blocks.back().get();
+    } else {
+        blockUsed = (blockUsed + kRecordAlign - 1) & ~(kRecordAlign - 1);
+        if (!block || blockUsed + size > kBlockBytes) {
+            blocks.emplace_back(new char[kBlockBytes]);
+            blockBytes += kBlockBytes;
+            block = blocks.back().get();
+            blockUsed = 0;
+        }
+        data = block + blockUsed;
+        blockUsed += size;
+    }
+    Header header{hash, static_cast<uint32_t>(word.size())};
+    std::memcpy(data, &header, sizeof(header));
+    if (!word.empty()) std::memcpy(data + sizeof(Header), word.data(), word.size());
+    return data;
+}
+
+// Builds a larger table from every existing id, then swaps it in
+void Vocabulary::rehash(size_t slots) {
+    auto next = std::make_unique<Table>();
+    next->mask = slots - 1;
+    next->slots = std::make_unique<std::atomic<uint32_t>[]>(slots);
+    for (size_t i = 0; i < slots; ++i) next->slots[i].store(0, std::memory_order_relaxed);
+
+    size_t ids = count.load(std::memory_order_relaxed);
+    for (Id id = 0; id < ids; ++id) {
+        std::string_view existing = word(id);
+        place(*next, hashOf(existing), id);
+    }
+    table.store(next.get(), std::memory_order_release);
+    tables.push_back(std::move(next));
+}
+
+void Vocabulary::place(Table& target, size_t hash, Id id) {
+    size_t i = hash & target.mask;
+    while (target.slots[i].load(std::memory_order_relaxed) != 0) i = (i + 1) & target.mask;
+    target.slots[i].store(id + 1, std::memory_order_release);
+}
+
+size_t Vocabulary::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    size_t bytes = blockBytes + blocks.capacity() * sizeof(blocks[0]);
+    for (int s = 0; s < kSegments; ++s) {
+        if (segments[s].load(std::memory_order_relaxed)) bytes += (kFirstSegment << s) * sizeof(const char*);
+    }
+    for (const auto& replaced : tables) bytes += sizeof(Table) + (replaced->mask + 1) * sizeof(std::atomic<uint32_t>);
+    return bytes;
+}
@@ -6,12 +6,12 @@
 // Main function to run the chatbot
 int main() {
     try {
-        // Initialize NeuralNet and ResponseVariator
-        NeuralNet neuralNet;
+        // Initialize ResponseVariator; its NeuralNet shares the same database connection
         ResponseVariator bot;
+        NeuralNet& neuralNet = bot.neuralNet;
 
         // Load the pre-trained model if it exists
-        std::string modelFile = "trained_model.txt";  // Specify your trained model file
+        std::string modelFile = "trained_model.bin";  // Specify your trained model file
         std::cout << "Loading model from: " << modelFile << std::endl;
         neuralNet.loadModelFromFile(modelFile);  // Load pre-trained embeddings into memory
 
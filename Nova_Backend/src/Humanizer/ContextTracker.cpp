@@ -1,23 +1,50 @@
 #include "../../include/Humanizer/ContextTracker.hpp"
+#include "../../include/Core/Tokenizer.hpp"
 #include <sstream>
+#include <iomanip>
 #include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <vector>
 
+namespace {
+    const double kTurnGrowth = std::pow(2.0, 1.0 / ContextTracker::TOPIC_HALF_LIFE);  // Scale factor per turn
+    const double kRescaleAt = 1e12;  // Folded back into the weights before precision suffers
 
-ContextTracker::ContextTracker() {}
+    // The first `limit` bytes of text, cut on a UTF-8 character boundary
+    size_t clippedLength(std::string_view text, size_t limit) {
+        if (text.size() <= limit) return text.size();
+        size_t length = limit;
+        while (length > 0 && (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80) --length;
+        return length;
+    }
 
-void ContextTracker::addToContext(const std::string& message) {
-    contextDeque.push_back(message);
-    if (contextDeque.size() > MAX_CONTEXT_SIZE) {
-        contextDeque.pop_front();
+    std::string_view topicKey(std::string_view topic) {
+        return topic.substr(0, clippedLength(topic, ContextTracker::MAX_TOPIC_BYTES));
     }
 }
 
+ContextTracker::ContextTracker() {
+    for (auto& slot : messages) slot.reserve(MAX_MESSAGE_BYTES);
+    for (auto& entry : topics) entry.topic.reserve(MAX_TOPIC_BYTES);
+}
+
+const std::string& ContextTracker::message(size_t age) const {
+    return messages[(newest + MAX_CONTEXT_SIZE - age) % MAX_CONTEXT_SIZE];
+}
+
+// Overwrites the oldest slot in place; cut on a UTF-8 character boundary
+void ContextTracker::addToContext(const std::string& message) {
+    size_t length = clippedLength(message, MAX_MESSAGE_BYTES);
+    newest = (newest + 1) % MAX_CONTEXT_SIZE;
+    messages[newest].assign(message, 0, length);
+    messageCount = std::min(messageCount + 1, MAX_CONTEXT_SIZE);
+}
+
 std::deque<std::string> ContextTracker::getRecentMessages(size_t count) const {
     std::deque<std::string> recentMessages;
-    for (size_t i = 0; i < count && i < contextDeque.size(); ++i) {
-        recentMessages.push_back(contextDeque[contextDeque.size() - 1 - i]);
+    for (size_t i = 0; i < count && i < messageCount; ++i) {
+        recentMessages.push_back(message(i));
     }
     return recentMessages;
 }
@@ -25,52 +52,118 @@ std::deque<std::string> ContextTracker::getRecentMessages(size_t count) const {
 
 void ContextTracker::addMessage(const std::string& message) {
     addToContext(message);
+
+    scale *= kTurnGrowth;
+    if (scale > kRescaleAt) {
+        for (size_t i = 0; i < topicCount; ++i) topics[i].weight /= scale;
+        scale = 1.0;
+    }
 }
 
 std::string ContextTracker::getRecentContext() const {
     std::ostringstream oss;
-    for (const auto& msg : contextDeque) {
-        oss << msg << " ";
+    for (size_t age = messageCount; age-- > 0;) {
+        oss << message(age) << " ";
     }
     return oss.str();
 }
 
 std::string ContextTracker::summarizeContext() const {
+    // Topics mentioned more than once lately, strongest first
     std::ostringstream oss;
-    for (const auto& [topic, score] : topicRelevance) {
-        if (score > 1) oss << topic << "(" << score << ") ";
+    oss << std::fixed << std::setprecision(1);
+    for (const auto& [topic, score] : topTopics(MAX_TOPICS)) {
+        if (score <= 1.0f) break;
+        oss << topic << "(" << score << ") ";
     }
     return oss.str();
 }
 
 bool ContextTracker::topicExists(const std::string& topic) const {
-    return topicRelevance.find(topic) != topicRelevance.end();
+    return findTopic(topicKey(topic)) != nullptr;
+}
+
+float ContextTracker::topicScore(const std::string& topic) const {
+    const TopicScore* entry = findTopic(topicKey(topic));
+    return entry ? static_cast<float>(entry->weight / scale) : 0.0f;
+}
+
+std::vector<std::pair<std::string_view, float>> ContextTracker::topTopics(size_t count) const {
+    std::vector<std::pair<std::string_view, float>> top;
+    for (size_t i = 0; i < count && i < topicCount; ++i) {
+        top.emplace_back(topics[i].topic, static_cast<float>(topics[i].weight / scale));
+    }
+    return top;
 }
 
 void ContextTracker::boostTopicRelevance(const std::string& topic, int amount) {
-    topicRelevance[topic] += amount;
+    boost(topicKey(topic), amount);
+}
+
+const ContextTracker::TopicScore* ContextTracker::findTopic(std::string_view topic) const {
+    for (size_t i = 0; i < topicCount; ++i) {
+        if (topics[i].topic == topic) return &topics[i];
+    }
+    return nullptr;
+}
+
+// Updates one entry and moves it to its place in the order; a full table drops its lowest score
+void ContextTracker::boost(std::string_view topic, int amount) {
+    double added = amount * scale;
+    size_t i = 0;
+    while (i < topicCount && topics[i].topic != topic) ++i;
+    if (i < topicCount) {
+        topics[i].weight += added;
+    } else {
+        if (topicCount == MAX_TOPICS) {
+            if (added < topics[MAX_TOPICS - 1].weight) return;  // Weaker than everything tracked
+            i = MAX_TOPICS - 1;
+        } else {
+            i = topicCount++;
+        }
+        topics[i].topic.assign(topic);  // Fits the reserved storage; no allocation
+        topics[i].weight = added;
+    }
+
+    while (i > 0 && topics[i].weight > topics[i - 1].weight) {
+        std::swap(topics[i], topics[i - 1]);
+        --i;
+    }
+    while (i + 1 < topicCount && topics[i].weight < topics[i + 1].weight) {
+        std::swap(topics[i], topics[i + 1]);
+        ++i;
+    }
 }
 
 std::set<std::string> ContextTracker::extractKeywords(const std::string& message) const {
     std::set<std::string> keywords;
-    std::istringstream iss(message);
-    std::string word;
-    while (iss >> word) {
-        if (word.size() > 3) keywords.insert(word);
+    for (const auto& token : Tokenizer::local().tokenize(message)) {
+        if (token.text.size() > 3) keywords.emplace(token.text);
     }
     return keywords;
 }
 std::vector<std::string> ContextTracker::getRelevantContext() const {
     std::vector<std::string> relevantContext;
-    for (const auto& msg : contextDeque) {
-        relevantContext.push_back(msg);
+    for (size_t age = messageCount; age-- > 0;) {
+        relevantContext.push_back(message(age));
     }
     return relevantContext;
 }
 
+void ContextTracker::clearContext() {
+    messageCount = 0;  // Slots keep their reserved storage
+    topicCount = 0;
+    scale = 1.0;
+}
+
 void ContextTracker::boostTopicRelevanceByKeywords(const std::string& message) {
-    auto keywords = extractKeywords(message);
-    for (const auto& keyword : keywords) {
-        boostTopicRelevance(keyword, 1); // boost topic relevance
+    // The keywords extractKeywords would list, each once, without copying them
+    std::vector<std::string_view> boosted;
+    for (const auto& token : Tokenizer::local().tokenize(message)) {
+        if (token.text.size() <= 3) continue;
+        std::string_view key = topicKey(token.text);
+        if (std::find(boosted.begin(), boosted.end(), key) != boosted.end()) continue;
+        boosted.push_back(key);
+        boost(key, 1); // boost topic relevance
     }
-}
\ No newline at end of file
+}
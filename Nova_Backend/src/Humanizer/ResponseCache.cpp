@@ -0,0 +1,170 @@
+#include "../../include/Humanizer/ResponseCache.hpp"
+#include "../../include/Core/BKTree.hpp"
+#include <algorithm>
+#include <functional>
+
+ResponseCache::ResponseCache(size_t capacity)
+    : shardCapacity(std::max<size_t>(1, (capacity + kShards - 1) / kShards)), shards(new Shard[kShards]) {}
+
+// High hash bits pick the shard, so each shard's own map still sees well-spread low bits
+ResponseCache::Shard& ResponseCache::shardFor(const std::string& key) const {
+    size_t hash = std::hash<std::string>()(key);
+    return shards[(hash >> 24) % kShards];
+}
+
+std::shared_ptr<const ResponseCache::Entry> ResponseCache::find(const std::string& key) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.byKey.find(key);
+    if (it == shard.byKey.end()) {
+        shard.misses++;
+        return nullptr;
+    }
+    shard.hits++;
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+    return it->second->entry;
+}
+
+void ResponseCache::insert(const std::string& key, Entry entry) {
+    auto stored = std::make_shared<const Entry>(std::move(entry));
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    put(shard, key, std::move(stored));
+}
+
+std::string ResponseCache::findGenerated(const std::string& key, const std::string& input, uint64_t modelVersion) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.byKey.find(key);
+    if (it != shard.byKey.end()) {
+        const Entry& entry = *it->second->entry;
+        if (entry.modelVersion != 0 && entry.modelVersion == modelVersion && entry.generatedFor == input) {
+            shard.generatedHits++;
+            return entry.generated;
+        }
+    }
+    shard.generatedMisses++;
+    return "";
+}
+
+// Teaching between the index stage and the NN stage may have dropped the entry; then nothing is stored
+void ResponseCache::setGenerated(const std::string& key, const std::string& input, const std::string& generated, uint64_t modelVersion) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.byKey.find(key);
+    if (it == shard.byKey.end() || !it->second->entry->topic.empty()) return;
+
+    Node& node = *it->second;
+    auto updated = std::make_shared<Entry>(*node.entry);
+    updated->generated = generated;
+    updated->generatedFor = input;
+    updated->modelVersion = modelVersion;
+    shard.bytes -= node.bytes;
+    node.bytes = footprint(node.key, *updated);
+    shard.bytes += node.bytes;
+    node.entry = std::move(updated);
+}
+
+void ResponseCache::invalidate(const std::vector<std::string>& changed, const std::vector<std::string>& added) {
+    BKTree addedTopics;
+    for (const auto& topic : added) addedTopics.insert(topic);
+
+    for (size_t s = 0; s < kShards; ++s) {
+        Shard& shard = shards[s];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        for (const auto& topic : changed) {
+            auto it = shard.byTopic.find(topic);
+            if (it == shard.byTopic.end()) continue;
+            auto nodes = it->second;  // erase() edits the list
+            for (auto node : nodes) erase(shard, node);
+            shard.invalidations += nodes.size();
+        }
+
+        // A new topic can only take over inputs that did not match exactly
+        if (addedTopics.size() == 0) continue;
+        std::string closest;
+        for (auto node = shard.lru.begin(); node != shard.lru.end();) {
+            auto current = node++;
+            if (current->entry->topic == current->key) continue;
+            if (addedTopics.findClosest(current->key, kFuzzyDistance, closest)) {
+                erase(shard, current);
+                shard.invalidations++;
+            }
+        }
+    }
+}
+
+void ResponseCache::clear() {
+    for (size_t s = 0; s < kShards; ++s) {
+        Shard& shard = shards[s];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.invalidations += shard.lru.size();
+        shard.byKey.clear();
+        shard.byTopic.clear();
+        shard.lru.clear();
+        shard.bytes = 0;
+    }
+}
+
+ResponseCache::Stats ResponseCache::stats() const {
+    Stats total;
+    total.capacity = shardCapacity * kShards;
+    for (size_t s = 0; s < kShards; ++s) {
+        const Shard& shard = shards[s];
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        total.hits += shard.hits;
+        total.misses += shard.misses;
+        total.generatedHits += shard.generatedHits;
+        total.generatedMisses += shard.generatedMisses;
+        total.evictions += shard.evictions;
+        total.invalidations += shard.invalidations;
+        total.entries += shard.lru.size();
+        total.bytes += shard.bytes;
+    }
+    return total;
+}
+
+void ResponseCache::put(Shard& shard, const std::string& key, std::shared_ptr<const Entry> entry) {
+    auto existing = shard.byKey.find(key);
+    if (existing != shard.byKey.end()) erase(shard, existing->second);
+
+    size_t bytes = footprint(key, *entry);
+    shard.lru.push_front(Node{key, std::move(entry), bytes});
+    auto node = shard.lru.begin();
+    shard.byKey.emplace(node->key, node);
+    if (!node->entry->topic.empty()) shard.byTopic[node->entry->topic].push_back(node);
+    shard.bytes += bytes;
+
+    while (shard.lru.size() > shardCapacity) {
+        erase(shard, std::prev(shard.lru.end()));
+        shard.evictions++;
+    }
+}
+
+void ResponseCache::erase(Shard& shard, NodeList::iterator node) {
+    const std::string& topic = node->entry->topic;
+    if (!topic.empty()) {
+        auto it = shard.byTopic.find(topic);
+        if (it != shard.byTopic.end()) {
+            auto& nodes = it->second;
+            nodes.erase(std::find(nodes.begin(), nodes.end(), node));
+            if (nodes.empty()) shard.byTopic.erase(it);
+        }
+    }
+    shard.byKey.erase(node->key);
+    shard.bytes -= node->bytes;
+    shard.lru.erase(node);
+}
+
+// Strings by capacity plus the fixed size of each structure that points at the entry
+size_t ResponseCache::footprint(const std::string& key, const Entry& entry) {
+    size_t bytes = sizeof(Node) + 2 * sizeof(void*)  // List node
+                 + sizeof(std::pair<std::string_view, NodeList::iterator>) + 2 * sizeof(void*)  // byKey node and bucket
+                 + sizeof(Entry) + 2 * sizeof(long)  // shared_ptr control block
+                 + key.capacity() + entry.topic.capacity() + entry.generated.capacity() + entry.generatedFor.capacity()
+                 + entry.candidates.capacity() * sizeof(ResponseCandidate);
+    for (const auto& candidate : entry.candidates) bytes += candidate.response.capacity() + candidate.topic.capacity();
+    if (!entry.topic.empty()) bytes += sizeof(NodeList::iterator);  // byTopic slot
+    return bytes;
+}
@@ -1,19 +1,23 @@
 // ResponseSelector.cpp
 #include "../../include/Humanizer/ResponseSelector.hpp"
+#include "../../include/Core/VectorCodec.hpp"
 #include <iostream>
 #include <algorithm>
 #include <ctime>
 #include <random>
 
-ResponseSelector::ResponseSelector(const std::string& dbPath) {
-    if (sqlite3_open(dbPath.c_str(), &db)) {
-        std::cerr << "Failed to open DB: " << sqlite3_errmsg(db) << std::endl;
-        db = nullptr;
-    } else {
+ResponseSelector::ResponseSelector(std::shared_ptr<DatabasePool> databasePool)
+    : pool(std::move(databasePool)), nn(pool), db(pool->primary()) {
+    if (db.isOpen()) {
         initializeDB();
+        loadRows();
     }
 }
 
+ResponseSelector::~ResponseSelector() {
+    flushUsage();
+}
+
 void ResponseSelector::initializeDB() {
     const char* createTableSQL =
         "CREATE TABLE IF NOT EXISTS chatbot ("
@@ -23,69 +27,136 @@ void ResponseSelector::initializeDB() {
         "confidence REAL DEFAULT 0.5,"
         "tag TEXT DEFAULT '',"
         "use_count INTEGER DEFAULT 0,"
-        "last_used INTEGER DEFAULT 0"
+        "last_used INTEGER DEFAULT 0,"
+        "topic_vec BLOB"
         ");";
 
-    char* errMsg = nullptr;
-    if (sqlite3_exec(db, createTableSQL, nullptr, nullptr, &errMsg) != SQLITE_OK) {
-        std::cerr << "DB table creation failed: " << errMsg << std::endl;
-        sqlite3_free(errMsg);
+    if (!db.exec(createTableSQL)) {
+        std::cerr << "DB table creation failed." << std::endl;
+        return;
+    }
+
+    // Tables created before topic vectors were cached lack the column
+    bool hasTopicVec = false;
+    if (auto stmt = db.prepare("PRAGMA table_info(chatbot);")) {
+        while (stmt.step() == SQLITE_ROW) {
+            const unsigned char* name = sqlite3_column_text(stmt, 1);
+            if (name && std::string(reinterpret_cast<const char*>(name)) == "topic_vec") hasTopicVec = true;
+        }
+    }
+    if (!hasTopicVec && !db.exec("ALTER TABLE chatbot ADD COLUMN topic_vec BLOB;")) {
+        std::cerr << "Adding topic_vec column failed." << std::endl;
+    }
+}
+
+void ResponseSelector::loadRows() {
+    rows.clear();
+    topicVectors.clear();
+
+    auto stmt = db.prepare("SELECT id, topic, response, confidence, topic_vec FROM chatbot ORDER BY id;");
+    if (!stmt) {
+        std::cerr << "Failed to load chatbot rows." << std::endl;
+        return;
+    }
+
+    std::vector<std::pair<int, std::vector<float>>> computed;  // Vectors to persist
+    std::vector<float> topicVec;
+    while (stmt.step() == SQLITE_ROW) {
+        int id = sqlite3_column_int(stmt, 0);
+        std::string topic = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
+        std::string response = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
+        float confidence = static_cast<float>(sqlite3_column_double(stmt, 3));
+
+        if (!VectorCodec::readColumn(stmt, 4, topicVec)) {
+            topicVec = nn.vectorize(topic);  // First load of this row
+            computed.emplace_back(id, topicVec);
+        }
+        topicVec.resize(topicVectors.dimension(), 0.0f);
+
+        topicVectors.set(static_cast<uint32_t>(rows.size()), topicVec.data());
+        rows.push_back({id, response, confidence});
+    }
+
+    if (computed.empty()) return;
+
+    db.exec("BEGIN;");
+    for (const auto& [id, vec] : computed) {
+        auto update = db.prepare("UPDATE chatbot SET topic_vec = ? WHERE id = ?;");
+        if (!update) break;
+        VectorCodec::bindVector(update, 1, vec);
+        sqlite3_bind_int(update, 2, id);
+        update.step();
+    }
+    db.exec("COMMIT;");
+    std::cout << "[ResponseSelector] Cached topic vectors for " << computed.size() << " rows." << std::endl;
+}
+
+void ResponseSelector::addResponse(const std::string& topic, const std::string& response, float confidence, const std::string& tag) {
+    std::vector<float> topicVec = nn.vectorize(topic);  // Computed once, at insert time
+    auto stmt = db.prepare("INSERT INTO chatbot (topic, response, confidence, tag, topic_vec) VALUES (?, ?, ?, ?, ?);");
+    if (!stmt) return;
+
+    sqlite3_bind_text(stmt, 1, topic.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_text(stmt, 2, response.c_str(), -1, SQLITE_STATIC);
+    sqlite3_bind_double(stmt, 3, confidence);
+    sqlite3_bind_text(stmt, 4, tag.c_str(), -1, SQLITE_STATIC);
+    VectorCodec::bindVector(stmt, 5, topicVec);
+    if (stmt.step() == SQLITE_DONE) {
+        topicVec.resize(topicVectors.dimension(), 0.0f);
+        topicVectors.set(static_cast<uint32_t>(rows.size()), topicVec.data());
+        rows.push_back({static_cast<int>(sqlite3_last_insert_rowid(db.handle())), response, confidence});
+    } else {
+        std::cerr << "Failed to insert response: " << db.errorMessage() << std::endl;
     }
 }
 
 std::string ResponseSelector::chooseBest(const std::string& input) {
-    if (!db) return "";
+    if (rows.empty()) return "";
 
     std::vector<float> inputVec = nn.vectorize(input);
 
-    std::string sql = "SELECT id, topic, response, confidence, tag, use_count FROM chatbot";
-    sqlite3_stmt* stmt;
-    std::vector<std::tuple<int, std::string, float>> candidates;
+    // similarity * confidence for every row in one pass over the topic matrix
+    topicVectors.score(inputVec, scores);
+    std::vector<size_t> candidates;
     float bestScore = -1e9f;
-
-    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            int id = sqlite3_column_int(stmt, 0);
-            std::string topic = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-            std::string response = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2));
-            float confidence = static_cast<float>(sqlite3_column_double(stmt, 3));
-            std::string tag = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 4));
-
-            std::vector<float> topicVec = nn.vectorize(topic);
-            float similarity = 0.0f;
-            for (int i = 0; i < topicVec.size(); ++i)
-                similarity += inputVec[i] * topicVec[i];
-
-            float score = similarity * confidence;
-
-            if (score > bestScore) {
-                bestScore = score;
-                candidates.clear();
-                candidates.emplace_back(id, response, score);
-            } else if (score == bestScore) {
-                candidates.emplace_back(id, response, score);
-            }
+    for (size_t i = 0; i < rows.size(); ++i) {
+        float score = scores[i] * rows[i].confidence;
+        if (score > bestScore) {
+            bestScore = score;
+            candidates.clear();
+            candidates.push_back(i);
+        } else if (score == bestScore) {
+            candidates.push_back(i);
         }
-        sqlite3_finalize(stmt);
     }
 
-    if (candidates.empty()) return "";
-
     // Random shuffle among best-scored responses
     std::random_device rd;
     std::mt19937 rng(rd());
-    std::uniform_int_distribution<int> dist(0, candidates.size() - 1);
-    auto [chosenId, chosenResponse, _] = candidates[dist(rng)];
-
-    // Update usage stats
-    std::string updateSQL = "UPDATE chatbot SET use_count = use_count + 1, last_used = ? WHERE id = ?";
-    sqlite3_stmt* updateStmt;
-    if (sqlite3_prepare_v2(db, updateSQL.c_str(), -1, &updateStmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_int(updateStmt, 1, static_cast<int>(std::time(nullptr)));
-        sqlite3_bind_int(updateStmt, 2, chosenId);
-        sqlite3_step(updateStmt);
-        sqlite3_finalize(updateStmt);
-    }
+    std::uniform_int_distribution<size_t> dist(0, candidates.size() - 1);
+    const Row& chosen = rows[candidates[dist(rng)]];
+
+    // Record usage; written to the database in batches
+    auto& usage = pendingUsage[chosen.id];
+    usage.first += 1;
+    usage.second = static_cast<int>(std::time(nullptr));
+    if (pendingUsage.size() >= kUsageBatch) flushUsage();
+
+    return chosen.response;
+}
+
+void ResponseSelector::flushUsage() {
+    if (!db.isOpen() || pendingUsage.empty()) return;
 
-    return chosenResponse;
-}
\ No newline at end of file
+    db.exec("BEGIN;");
+    for (const auto& [id, usage] : pendingUsage) {
+        auto updateStmt = db.prepare("UPDATE chatbot SET use_count = use_count + ?, last_used = ? WHERE id = ?");
+        if (!updateStmt) break;
+        sqlite3_bind_int(updateStmt, 1, usage.first);
+        sqlite3_bind_int(updateStmt, 2, usage.second);
+        sqlite3_bind_int(updateStmt, 3, id);
+        updateStmt.step();
+    }
+    db.exec("COMMIT;");
+    pendingUsage.clear();
+}
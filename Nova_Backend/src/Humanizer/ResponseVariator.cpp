@@ -1,24 +1,41 @@
 #include "../../include/Humanizer/ResponseVariator.hpp"
 #include "../../include/Core/NeuralNet.hpp"
 #include "../../include/utils.hpp"
+#include "../../include/Core/EditDistance.hpp"
+#include "../../include/Core/VectorCodec.hpp"
+#include "../../include/Core/CsvReader.hpp"
+#include "../../include/Core/VectorMath.hpp"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <filesystem>
-#include <sqlite3.h>
+#include <chrono>
+#include <cstdlib>
 #include <random>
+#include <set>
 
-ResponseVariator::ResponseVariator() {
-    rng.seed(std::random_device{}());
+ResponseVariator::ResponseVariator(std::shared_ptr<DatabasePool> databasePool, NeuralNet::WarmUp warmUp)
+    : neuralNet(databasePool, warmUp), pool(std::move(databasePool)), db(pool->primary()) {
     createTablesIfNotExist();
+    topicIndex.load(db.handle());
+
+    // Feedback is persisted on a second connection by a background writer
+    feedbackDb = pool->openConnection();
+    feedbackThread = std::thread(&ResponseVariator::feedbackLoop, this);
 }
 
-void ResponseVariator::createTablesIfNotExist() {
-    if (sqlite3_open("D:/Nova_Project/Nova_Backend/chatbot.db", &db) != SQLITE_OK) {
-        std::cerr << "DB error: " << sqlite3_errmsg(db) << std::endl;
-        return;
+ResponseVariator::~ResponseVariator() {
+    {
+        std::lock_guard<std::mutex> lock(feedbackMutex);
+        stopFeedback = true;
     }
+    feedbackCv.notify_all();
+    if (feedbackThread.joinable()) feedbackThread.join();
+}
+
+void ResponseVariator::createTablesIfNotExist() {
+    if (!db.isOpen()) return;  // Database already reported the error
 
     const char* responseTable = R"(
         CREATE TABLE IF NOT EXISTS responses (
@@ -38,12 +55,11 @@ void ResponseVariator::createTablesIfNotExist() {
         );
     )";
 
-    char* err;
-    if (sqlite3_exec(db, responseTable, 0, 0, &err) != SQLITE_OK ||
-        sqlite3_exec(db, vectorTable, 0, 0, &err) != SQLITE_OK) {
-        std::cerr << "SQL error: " << err << std::endl;
-        sqlite3_free(err);
-    }
+    if (!db.exec(responseTable)) return;
+    db.exec(vectorTable);
+
+    // Feedback updates look rows up by (topic, response)
+    db.exec("CREATE INDEX IF NOT EXISTS idx_responses_topic_response ON responses (topic, response);");
 }
 
 #include <random>
@@ -51,62 +67,32 @@ void ResponseVariator::createTablesIfNotExist() {
 
 //super fn
 std::string ResponseVariator::getResponse(const std::string& input) {
-    std::cout << "Getting response for input: " << input << std::endl;
-
-    // Query the database for responses based on the input (topic)
-    const char* sql = "SELECT response, confidence FROM responses WHERE topic = ?;";
-    sqlite3_stmt* stmt;
-    std::vector<std::pair<std::string, float>> responses;
+    return getResponse(input, conversation);
+}
 
-    // First, check for exact matches
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, input.c_str(), -1, SQLITE_STATIC);
+std::string ResponseVariator::getResponse(const std::string& input, Conversation& conversation) {
+    std::cout << "Getting response for input: " << input << std::endl;
 
-        // Loop through all responses
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            std::string response = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            float confidence = static_cast<float>(sqlite3_column_double(stmt, 1));
-            responses.push_back({response, confidence});
-        }
-        sqlite3_finalize(stmt);
-    } else {
-        std::cerr << "Database query failed: " << sqlite3_errmsg(db) << std::endl;
+    std::string response = getIndexedResponse(input, conversation);
+    if (response.empty()) {
+        response = getGeneratedResponse(input);
     }
+    recordTurn(conversation, input);
+    return response;
+}
 
-    // If responses found in the database, select the response with the highest confidence
-    if (!responses.empty()) {
-        // Sort the responses by confidence (highest first)
-        std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(responses.begin(), responses.end(), g);  // Randomize to avoid bias
-        std::sort(responses.begin(), responses.end(), [](const auto& a, const auto& b) {
-            return a.second > b.second;  // Sort by confidence
-        });
-
-        // Return the response with the highest confidence
-        return responses.front().first;
-    }
+void ResponseVariator::recordTurn(Conversation& conversation, const std::string& input) const {
+    conversation.context.addMessage(input);
+    conversation.lastTopic = TopicIndex::normalize(input);
+    conversation.turnCount++;
+}
 
-    // No match found in DB, check for a similar word using Levenshtein Distance
-    std::cout << "No exact match found in DB. Checking for similar words..." << std::endl;
-
-    std::string closestMatch = findSimilarWord(input);
-    if (!closestMatch.empty()) {
-        // Return the response corresponding to the closest match
-        std::cout << "Found similar word: " << closestMatch << std::endl;
-        
-        // Query for the response associated with the similar word
-        const char* sqlSimilar = "SELECT response FROM responses WHERE topic = ?;";
-        if (sqlite3_prepare_v2(db, sqlSimilar, -1, &stmt, nullptr) == SQLITE_OK) {
-            sqlite3_bind_text(stmt, 1, closestMatch.c_str(), -1, SQLITE_STATIC);
-
-            if (sqlite3_step(stmt) == SQLITE_ROW) {
-                std::string response = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-                sqlite3_finalize(stmt);
-                return response; // Return the response corresponding to the similar word
-            }
-        }
-    }
+std::string ResponseVariator::getGeneratedResponse(const std::string& input) const {
+    // Reuse the answer while the NeuralNet has not changed since it was computed
+    std::string key = TopicIndex::normalize(input);
+    uint64_t modelVersion = neuralNet.version();
+    std::string cached = responseCache.findGenerated(key, input, modelVersion);
+    if (!cached.empty()) return cached;
 
     std::cout << "No similar word found. Generating response using NN..." << std::endl;
 
@@ -115,64 +101,88 @@ std::string ResponseVariator::getResponse(const std::string& input) {
 
     // If NN fails to generate a meaningful response (empty), fallback to default message
     if (generatedResponse.empty()) {
-        return "I don't know yet.";
+        generatedResponse = "I don't know yet.";
     }
 
-    // Return the generated response
+    responseCache.setGenerated(key, input, generatedResponse, modelVersion);
     return generatedResponse;
 }
 
-//string similarity
-int ResponseVariator::levenshteinDistance(const std::string& a, const std::string& b) {
-    std::vector<std::vector<int>> dist(a.size() + 1, std::vector<int>(b.size() + 1));
-
-    for (int i = 0; i <= a.size(); ++i) {
-        for (int j = 0; j <= b.size(); ++j) {
-            if (i == 0) {
-                dist[i][j] = j;
-            } else if (j == 0) {
-                dist[i][j] = i;
-            } else {
-                dist[i][j] = std::min({
-                    dist[i - 1][j] + 1, // Deletion
-                    dist[i][j - 1] + 1, // Insertion
-                    dist[i - 1][j - 1] + (a[i - 1] != b[j - 1]) // Substitution
-                });
+// The stages that only need the topic index, which is loaded before the constructor returns
+std::string ResponseVariator::getIndexedResponse(const std::string& input, Conversation& conversation) {
+    // A cached entry holds the candidates the stages below would find, or none
+    std::string key = TopicIndex::normalize(input);
+    if (auto cached = responseCache.find(key)) {
+        if (cached->candidates.empty()) return {};
+        return pickCandidate(cached->candidates, conversation.rng);
+    }
+
+    // First, check for exact matches in the resident topic index
+    ResponseCache::Entry entry;
+    if (const auto* candidates = topicIndex.find(key)) {
+        entry.topic = key;
+        entry.candidates = topCandidates(*candidates);
+    } else {
+        // No exact match in the index, check for a similar word using Levenshtein Distance
+        std::cout << "No exact match found. Checking for similar words..." << std::endl;
+
+        std::string closestMatch = findSimilarWord(input);
+        if (!closestMatch.empty()) {
+            // Return the response corresponding to the closest match
+            std::cout << "Found similar word: " << closestMatch << std::endl;
+
+            // Look up the responses associated with the similar word
+            if (const auto* candidates = topicIndex.find(closestMatch)) {
+                entry.topic = closestMatch;
+                entry.candidates = topCandidates(*candidates);
             }
         }
     }
 
-    return dist[a.size()][b.size()];
+    std::string response = entry.candidates.empty() ? std::string() : pickCandidate(entry.candidates, conversation.rng);
+    responseCache.insert(key, std::move(entry));
+    return response;
 }
 
-//find
-std::string ResponseVariator::findSimilarWord(const std::string& input) {
-    std::string closestWord;
-    int minDistance = INT_MAX;
-
-    // Query database for words (assuming you are looking for the closest topic)
-    const char* sql = "SELECT topic FROM responses;";
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            std::string word = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-
-            // Calculate Levenshtein distance between the input and the word from DB
-            int distance = levenshteinDistance(input, word);
-            if (distance < minDistance) {
-                minDistance = distance;
-                closestWord = word;
-            }
-        }
-        sqlite3_finalize(stmt);
+// Pick the highest-confidence candidate, breaking ties randomly to avoid bias
+std::string ResponseVariator::pickCandidate(const std::vector<ResponseCandidate>& candidates, std::default_random_engine& rng) {
+    float best = candidates.front().confidence;
+    for (const auto& candidate : candidates) {
+        best = std::max(best, candidate.confidence);
     }
 
-    // If the distance is below a certain threshold, return the closest word
-    if (minDistance < 3) { 
-        return closestWord;
-    } else {
-        return ""; // No similar word found
+    std::vector<const ResponseCandidate*> top;
+    for (const auto& candidate : candidates) {
+        if (candidate.confidence == best) top.push_back(&candidate);
     }
+
+    std::uniform_int_distribution<size_t> dist(0, top.size() - 1);
+    return top[dist(rng)]->response;
+}
+
+// The candidates pickCandidate can choose from, in order; all a cache entry needs to pick the same way
+std::vector<ResponseCandidate> ResponseVariator::topCandidates(const std::vector<ResponseCandidate>& candidates) {
+    float best = candidates.front().confidence;
+    for (const auto& candidate : candidates) {
+        best = std::max(best, candidate.confidence);
+    }
+
+    std::vector<ResponseCandidate> top;
+    for (const auto& candidate : candidates) {
+        if (candidate.confidence == best) top.push_back(candidate);
+    }
+    return top;
+}
+
+//string similarity
+int ResponseVariator::levenshteinDistance(const std::string& a, const std::string& b) {
+    return EditDistance::levenshtein(a, b);
+}
+
+//find
+std::string ResponseVariator::findSimilarWord(const std::string& input) {
+    // Closest known topic within an edit distance of 2 (i.e. distance < 3)
+    return topicIndex.findSimilar(input, 2);
 }
 
 void ResponseVariator::addResponse(const std::string& topic, const std::string& response) {
@@ -180,41 +190,113 @@ void ResponseVariator::addResponse(const std::string& topic, const std::string&
     neuralNet.train(topic, response);  // Train the neural network with the new input-output pair
 }
 
-void ResponseVariator::saveResponse(const std::string& topic, const std::string& response, float confidence) {
+bool ResponseVariator::saveResponse(const std::string& topic, const std::string& response, float confidence) {
+    if (!insertResponse(topic, response, confidence)) return false;
+    bool newTopic = topicIndex.add(topic, response, confidence);  // Keep the resident index coherent
+
+    // A new topic may now be the closest fuzzy match for inputs near it
+    std::string key = TopicIndex::normalize(topic);
+    if (newTopic) responseCache.invalidate({}, {key});
+    else responseCache.invalidate({key});
+    return true;
+}
+
+bool ResponseVariator::insertResponse(const std::string& topic, const std::string& response, float confidence) {
     const char* sql = R"(
         INSERT INTO responses (topic, response, confidence, use_count, created_at)
         VALUES (?, ?, ?, 1, datetime('now'))
     )";
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
+    auto stmt = db.prepare(sql);
+    if (stmt) {
         sqlite3_bind_text(stmt, 1, topic.c_str(), -1, SQLITE_STATIC);
         sqlite3_bind_text(stmt, 2, response.c_str(), -1, SQLITE_STATIC);
         sqlite3_bind_double(stmt, 3, confidence);
-        sqlite3_step(stmt);
-        sqlite3_finalize(stmt);
+        if (stmt.step() == SQLITE_DONE) return true;
+        std::cerr << "Failed to save response: " << db.errorMessage() << std::endl;
     }
+    return false;
 }
 
+// The topic index changes now; the database follows within kFeedbackInterval.
+// Deltas are queued under the stored topic spellings, which the input may differ from in case or spacing
 void ResponseVariator::updateConfidenceInDatabase(const std::string& input, const std::string& response, bool positive) {
-    const char* updateQuery = 
-        "UPDATE responses SET confidence = confidence + ? WHERE topic = ? AND response = ?;";
-
-    sqlite3_stmt* stmt;
-    if (sqlite3_prepare_v2(db, updateQuery, -1, &stmt, nullptr) != SQLITE_OK) {
-        std::cerr << "Failed to prepare statement: " << sqlite3_errmsg(db) << std::endl;
-        return;
+    double change = positive ? 0.1 : -0.1;  // Confidence change based on positive or negative feedback
+    std::vector<std::string> storedTopics = topicIndex.adjustConfidence(input, response, static_cast<float>(change));
+    responseCache.invalidate({TopicIndex::normalize(input)});
+
+    {
+        std::lock_guard<std::mutex> lock(feedbackMutex);
+        feedbackStats.received++;
+        for (const auto& topic : storedTopics) {
+            auto [it, inserted] = pendingFeedback.try_emplace({topic, response}, 0.0);
+            it->second += change;
+            if (!inserted) feedbackStats.coalesced++;
+        }
     }
+    feedbackCv.notify_one();
+}
 
-    double change = positive ? 0.1 : -0.1;  // Confidence change based on positive or negative feedback
-    sqlite3_bind_double(stmt, 1, change);
-    sqlite3_bind_text(stmt, 2, input.c_str(), -1, SQLITE_STATIC);
-    sqlite3_bind_text(stmt, 3, response.c_str(), -1, SQLITE_STATIC);
+void ResponseVariator::feedbackLoop() {
+    std::unique_lock<std::mutex> lock(feedbackMutex);
+    while (true) {
+        feedbackCv.wait(lock, [this] { return stopFeedback || !pendingFeedback.empty(); });
+        if (pendingFeedback.empty()) break;  // Stopping with nothing left to write
+
+        // Let more clicks arrive (and coalesce) unless someone is waiting for them
+        feedbackCv.wait_for(lock, kFeedbackInterval, [this] { return stopFeedback || flushRequested; });
+
+        std::map<std::pair<std::string, std::string>, double> batch;
+        batch.swap(pendingFeedback);
+        flushRequested = false;
+        feedbackBusy = true;
+        lock.unlock();
+
+        auto start = std::chrono::steady_clock::now();
+        writeFeedback(batch);
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        lock.lock();
+        feedbackBusy = false;
+        feedbackStats.flushes++;
+        feedbackStats.rowsWritten += batch.size();
+        feedbackStats.lastFlushMs = ms;
+        feedbackStats.maxFlushMs = std::max(feedbackStats.maxFlushMs, ms);
+        feedbackStats.totalFlushMs += ms;
+        feedbackCv.notify_all();  // Wake flushFeedback()
+    }
+}
 
-    if (sqlite3_step(stmt) != SQLITE_DONE) {
-        std::cerr << "Failed to update confidence: " << sqlite3_errmsg(db) << std::endl;
+// Apply a batch of summed deltas in a single transaction
+void ResponseVariator::writeFeedback(const std::map<std::pair<std::string, std::string>, double>& batch) {
+    if (!feedbackDb || !feedbackDb->isOpen()) return;
+
+    feedbackDb->exec("BEGIN;");
+    for (const auto& [key, change] : batch) {
+        auto stmt = feedbackDb->prepare("UPDATE responses SET confidence = confidence + ? WHERE topic = ? AND response = ?;");
+        if (!stmt) break;
+        sqlite3_bind_double(stmt, 1, change);
+        sqlite3_bind_text(stmt, 2, key.first.c_str(), -1, SQLITE_STATIC);
+        sqlite3_bind_text(stmt, 3, key.second.c_str(), -1, SQLITE_STATIC);
+        if (stmt.step() != SQLITE_DONE) {
+            std::cerr << "Failed to update confidence: " << feedbackDb->errorMessage() << std::endl;
+        }
     }
+    feedbackDb->exec("COMMIT;");
+}
 
-    sqlite3_finalize(stmt);
+void ResponseVariator::flushFeedback() {
+    std::unique_lock<std::mutex> lock(feedbackMutex);
+    if (pendingFeedback.empty() && !feedbackBusy) return;
+    flushRequested = true;
+    feedbackCv.notify_all();
+    feedbackCv.wait(lock, [this] { return pendingFeedback.empty() && !feedbackBusy; });
+}
+
+ResponseVariator::FeedbackStats ResponseVariator::getFeedbackStats() const {
+    std::lock_guard<std::mutex> lock(feedbackMutex);
+    FeedbackStats stats = feedbackStats;
+    stats.queued = pendingFeedback.size();
+    return stats;
 }
 
 std::string ResponseVariator::getFallbackResponse() const {
@@ -239,17 +321,116 @@ std::string ResponseVariator::getFollowupSuggestion() {
 }
 
 void ResponseVariator::bulkTeachFromCSV(const std::string& filepath) {
-    std::ifstream file(filepath);
-    std::string line;
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        std::string topic, response, scoreStr;
-        if (std::getline(ss, topic, ',') && std::getline(ss, response, ',') && std::getline(ss, scoreStr)) {
-            float score = std::stof(scoreStr);
-            saveResponse(topic, response, score);
-            neuralNet.train(topic, response);  // Train the model with the new data
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file) {
+        std::cerr << "Could not open CSV file: " << filepath << std::endl;
+        return;
+    }
+
+    CsvReader reader(file);
+    std::vector<std::string> fields;
+    bool haveRecord = reader.next(fields);
+
+    // Header-less files use the old topic,response,score layout
+    size_t topicCol = 0, responseCol = 1, weightCol = 2;
+    auto isNumber = [](const std::string& text) {
+        char* end = nullptr;
+        std::strtof(text.c_str(), &end);
+        return end != text.c_str();
+    };
+    if (haveRecord && !fields.empty() && !isNumber(fields.back())) {
+        topicCol = responseCol = weightCol = fields.size();
+        for (size_t i = 0; i < fields.size(); ++i) {
+            std::string name = trim(fields[i]);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            if (name == "text" || ((name == "topic" || name == "input") && topicCol == fields.size())) topicCol = i;
+            else if (name == "response") responseCol = i;
+            else if (name == "weight" || name == "confidence" || name == "score") weightCol = i;
+        }
+        if (topicCol == fields.size() || responseCol == fields.size() || weightCol == fields.size()) {
+            std::cerr << "CSV header needs text (or topic), response and weight columns: " << filepath << std::endl;
+            return;
         }
+        haveRecord = reader.next(fields);
     }
+    size_t minFields = std::max({topicCol, responseCol, weightCol}) + 1;
+
+    // Insert in large transactions; a batch reaches the topic index only once its COMMIT
+    // succeeds, and training waits until every row is stored
+    auto start = std::chrono::steady_clock::now();
+    struct Row {
+        std::string topic, response;
+        float score;
+    };
+    std::vector<Row> batch;
+    std::vector<std::pair<std::string, std::string>> trainingPairs;
+    std::set<std::string> changedTopics, addedTopics;  // Normalized, for one cache invalidation at the end
+    size_t skipped = 0, lost = 0;
+    auto commitBatch = [&]() {
+        if (!db.exec("COMMIT;")) {
+            if (!sqlite3_get_autocommit(db.handle())) db.exec("ROLLBACK;");  // A failed COMMIT may leave it open
+            std::cerr << "[BulkTeach] Commit failed, " << batch.size() << " rows rolled back." << std::endl;
+            lost += batch.size();
+            batch.clear();
+            return;
+        }
+        for (auto& row : batch) {
+            bool newTopic = topicIndex.add(row.topic, row.response, row.score);
+            (newTopic ? addedTopics : changedTopics).insert(TopicIndex::normalize(row.topic));
+            trainingPairs.emplace_back(std::move(row.topic), std::move(row.response));
+        }
+        batch.clear();
+    };
+    if (!db.exec("BEGIN;")) {
+        std::cerr << "[BulkTeach] Could not start a transaction; nothing imported from " << filepath << std::endl;
+        return;
+    }
+    for (; haveRecord; haveRecord = reader.next(fields)) {
+        if (fields.size() < minFields) {
+            skipped++;
+            continue;
+        }
+        const std::string& weight = fields[weightCol];
+        char* end = nullptr;
+        float score = std::strtof(weight.c_str(), &end);
+        if (end == weight.c_str() || fields[topicCol].empty() || fields[responseCol].empty()) {
+            skipped++;
+            continue;
+        }
+
+        if (!insertResponse(fields[topicCol], fields[responseCol], score)) {
+            skipped++;
+            if (sqlite3_get_autocommit(db.handle())) {
+                // Some errors (disk full, I/O) roll the whole transaction back
+                std::cerr << "[BulkTeach] Transaction aborted, " << batch.size() << " rows rolled back." << std::endl;
+                lost += batch.size();
+                batch.clear();
+                if (!db.exec("BEGIN;")) {
+                    std::cerr << "[BulkTeach] Could not start a transaction; stopped importing " << filepath << std::endl;
+                    break;
+                }
+            }
+            continue;
+        }
+        batch.push_back({std::move(fields[topicCol]), std::move(fields[responseCol]), score});
+        if (batch.size() == kImportBatch) {
+            commitBatch();
+            if (!db.exec("BEGIN;")) {
+                std::cerr << "[BulkTeach] Could not start a transaction; stopped importing " << filepath << std::endl;
+                break;
+            }
+        }
+    }
+    if (!sqlite3_get_autocommit(db.handle())) commitBatch();  // Open unless the last BEGIN failed
+    responseCache.invalidate(std::vector<std::string>(changedTopics.begin(), changedTopics.end()),
+                             std::vector<std::string>(addedTopics.begin(), addedTopics.end()));
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (lost > 0) std::cerr << "[BulkTeach] " << lost << " rows were lost to failed commits." << std::endl;
+    std::cout << "[BulkTeach] Imported " << trainingPairs.size() << " rows (" << skipped << " skipped) in "
+              << seconds << " s, " << trainingPairs.size() / std::max(seconds, 1e-9) << " rows/s." << std::endl;
+
+    neuralNet.trainBatch(trainingPairs);
 }
 
 
@@ -259,6 +440,20 @@ void ResponseVariator::trainFromDatabaseForDev() {
     // Train using the data in the database
     neuralNet.trainFromDatabase(db);
 
+    // Then run the minibatch engine on the same pairs and report the fit; answers don't use these weights
+    TrainingConfig fitConfig;
+    fitConfig.epochs = 50;
+    fitConfig.learningRate = 0.5f;
+    fitConfig.batchSize = 64;
+    fitConfig.schedule = TrainingConfig::Schedule::Cosine;
+    fitConfig.patience = 5;
+    std::vector<float> weights;
+    std::vector<float> lossCurve = neuralNet.trainOnResponses(db, fitConfig, weights);
+    if (!lossCurve.empty()) {
+        std::cout << "Topic -> response fit: loss " << lossCurve.front() << " -> " << lossCurve.back()
+                  << " over " << lossCurve.size() << " epochs." << std::endl;
+    }
+
     // After training, save the model to a file
     saveModel();
     std::cout << "Training complete and model saved to file." << std::endl;
@@ -266,48 +461,18 @@ void ResponseVariator::trainFromDatabaseForDev() {
 
 
 
-std::string ResponseVariator::generateResponseFromNN(const std::string& input) {
+std::string ResponseVariator::generateResponseFromNN(const std::string& input) const {
     // Vectorize the input (obtain its embedding)
     auto inputVec = neuralNet.vectorize(input);
 
-    // Create a list to store candidate responses based on word similarity
-    std::vector<std::pair<std::string, float>> candidateResponses;
-
-    // Query all words from word_vectors table
-    const char* sql = "SELECT word, vector FROM word_vectors;";
-    sqlite3_stmt* stmt;
-
-    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) == SQLITE_OK) {
-        while (sqlite3_step(stmt) == SQLITE_ROW) {
-            std::string word = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0));
-            const char* vecData = reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1));
-
-            // Convert vector data from string to vector<float>
-            std::vector<float> wordVec;
-            std::istringstream vecStream(vecData);
-            float val;
-            while (vecStream >> val) {
-                wordVec.push_back(val);
-            }
-
-            // Calculate cosine similarity between input and word vector
-            float similarity = cosineSimilarity(inputVec, wordVec);
-            candidateResponses.push_back({word, similarity});
-        }
-        sqlite3_finalize(stmt);
-    }
-
-    // Sort the candidate words by similarity (highest first)
-    std::sort(candidateResponses.begin(), candidateResponses.end(), [](const auto& a, const auto& b) {
-        return a.second > b.second;  // Sort by similarity
-    });
+    // Find the most similar known words in the resident similarity index
+    int topN = 1;
+    auto candidateResponses = neuralNet.topK(inputVec, topN);
 
     // Generate a response by concatenating the most similar words
     std::string generatedResponse;
-    int topN = 1;
-
-    for (int i = 0; i < std::min(topN, (int)candidateResponses.size()); ++i) {
-        generatedResponse += candidateResponses[i].first + " ";
+    for (const auto& candidate : candidateResponses) {
+        generatedResponse += candidate.first + " ";
     }
 
     // Check if no suitable response was generated
@@ -322,34 +487,28 @@ std::string ResponseVariator::generateResponseFromNN(const std::string& input) {
 
 // Cosine similarity to measure the closeness between input and response embeddings
 float ResponseVariator::cosineSimilarity(const std::vector<float>& vec1, const std::vector<float>& vec2) {
-    float dotProduct = 0.0f;
-    float norm1 = 0.0f;
-    float norm2 = 0.0f;
-
-    for (size_t i = 0; i < vec1.size(); ++i) {
-        dotProduct += vec1[i] * vec2[i];
-        norm1 += vec1[i] * vec1[i];
-        norm2 += vec2[i] * vec2[i];
-    }
-
-    return dotProduct / (std::sqrt(norm1) * std::sqrt(norm2));  // Cosine similarity formula
+    return VectorMath::cosine(vec1.data(), vec2.data(), std::min(vec1.size(), vec2.size()));
 }
 
 double ResponseVariator::getConfidenceForResponse(const std::string& input, const std::string& response)
 {
-    const char* query =
-        "SELECT confidence FROM responses WHERE topic = ? AND response = ? LIMIT 1;";
-    sqlite3_stmt* stmt;
+    float confidence;
     double result = 0.5; // default mid confidence
 
-    if (sqlite3_prepare_v2(db, query, -1, &stmt, nullptr) == SQLITE_OK) {
-        sqlite3_bind_text(stmt, 1, input.c_str(), -1, SQLITE_STATIC);
-        sqlite3_bind_text(stmt, 2, response.c_str(), -1, SQLITE_STATIC);
-
-        if (sqlite3_step(stmt) == SQLITE_ROW) {
-            result = sqlite3_column_double(stmt, 0);
-        }
+    if (topicIndex.confidenceOf(input, response, confidence)) {
+        result = confidence;
     }
-    sqlite3_finalize(stmt);
     return std::clamp(result, 0.0, 1.0);
 }
+
+TopicIndex::Stats ResponseVariator::getTopicIndexStats() const {
+    return topicIndex.stats();
+}
+
+ResponseCache::Stats ResponseVariator::getResponseCacheStats() const {
+    return responseCache.stats();
+}
+
+void ResponseVariator::clearResponseCache() {
+    responseCache.clear();
+}
@@ -1,8 +1,6 @@
 #include "../../include/Core/TopicExtractor.hpp"
-#include <sstream>
+#include "../../include/Core/Tokenizer.hpp"
 #include <unordered_set>
-#include <algorithm>
-#include <cctype>
 #include <map>
 
 const std::unordered_set<std::string> TopicExtractor::stopwords = {
@@ -11,15 +9,7 @@ const std::unordered_set<std::string> TopicExtractor::stopwords = {
 };
 
 namespace {
-    std::string clean(const std::string& word) {
-        std::string result;
-        for (char c : word) {
-            if (std::isalnum(c)) result += std::tolower(c);
-        }
-        return result;
-    }
-
-    const std::map<std::string, std::string> aliasMap = {
+    const std::map<std::string, std::string, std::less<>> aliasMap = {
         {"bye", "goodbye"},
         {"hi", "hello"},
         {"hey", "hello"},
@@ -30,21 +20,19 @@ namespace {
         {"yep", "yes"}
     };
 
-    std::string normalize(const std::string& word) {
-        auto cleaned = clean(word);
-        auto it = aliasMap.find(cleaned);
-        return it != aliasMap.end() ? it->second : cleaned;
+    std::string_view normalize(std::string_view word) {
+        auto it = aliasMap.find(word);
+        return it != aliasMap.end() ? std::string_view(it->second) : word;
     }
 }
 
 std::vector<std::string> TopicExtractor::extract(const std::string& input) {
-    std::istringstream iss(input);
-    std::string word;
     std::vector<std::string> keywords;
+    std::string norm;
 
-    while (iss >> word) {
-        auto norm = normalize(word);
-        if (!norm.empty() && !stopwords.count(norm)) {
+    for (const auto& token : Tokenizer::local().tokenize(input)) {
+        norm.assign(normalize(token.text));
+        if (!stopwords.count(norm)) {
             keywords.push_back(norm);
         }
     }
@@ -0,0 +1,114 @@
+#include "../../include/Humanizer/TopicIndex.hpp"
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+
+std::string TopicIndex::normalize(const std::string& topic) {
+    size_t first = 0;
+    size_t last = topic.size();
+    while (first < last && std::isspace(static_cast<unsigned char>(topic[first]))) ++first;
+    while (last > first && std::isspace(static_cast<unsigned char>(topic[last - 1]))) --last;
+
+    std::string key;
+    key.reserve(last - first);
+    for (size_t i = first; i < last; ++i) {
+        key += static_cast<char>(std::tolower(static_cast<unsigned char>(topic[i])));
+    }
+    return key;
+}
+
+void TopicIndex::load(sqlite3* db) {
+    index.clear();
+    fuzzyIndex.clear();
+    candidateCount = 0;
+
+    const char* sql = "SELECT topic, response, confidence FROM responses ORDER BY id;";
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "[TopicIndex] Failed to load responses: " << sqlite3_errmsg(db) << std::endl;
+        return;
+    }
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        const unsigned char* topic = sqlite3_column_text(stmt, 0);
+        const unsigned char* response = sqlite3_column_text(stmt, 1);
+        if (!topic || !response) continue;  // Skip rows with NULL columns
+
+        add(reinterpret_cast<const char*>(topic),
+            reinterpret_cast<const char*>(response),
+            static_cast<float>(sqlite3_column_double(stmt, 2)));
+    }
+    sqlite3_finalize(stmt);
+
+    std::cout << "[TopicIndex] Indexed " << candidateCount << " responses across "
+              << index.size() << " topics." << std::endl;
+}
+
+const std::vector<ResponseCandidate>* TopicIndex::find(const std::string& topic) const {
+    auto it = index.find(normalize(topic));
+    if (it == index.end() || it->second.empty()) {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    hits.fetch_add(1, std::memory_order_relaxed);
+    return &it->second;
+}
+
+bool TopicIndex::add(const std::string& topic, const std::string& response, float confidence) {
+    std::string key = normalize(topic);
+    auto& candidates = index[key];
+    bool added = candidates.empty();
+    if (added) {
+        fuzzyIndex.insert(key);  // First response for this topic
+    }
+    candidates.push_back({response, confidence, topic});
+    ++candidateCount;
+    return added;
+}
+
+std::string TopicIndex::findSimilar(const std::string& topic, int maxDistance) const {
+    std::string closest;
+    if (!fuzzyIndex.findClosest(normalize(topic), maxDistance, closest)) {
+        return "";
+    }
+    return closest;
+}
+
+std::vector<std::string> TopicIndex::adjustConfidence(const std::string& topic, const std::string& response, float delta) {
+    std::vector<std::string> spellings;
+    auto it = index.find(normalize(topic));
+    if (it == index.end()) return spellings;
+
+    // Each spelling is one UPDATE ... WHERE topic = ? AND response = ? statement
+    for (auto& candidate : it->second) {
+        if (candidate.response == response) {
+            candidate.confidence += delta;
+            if (std::find(spellings.begin(), spellings.end(), candidate.topic) == spellings.end()) {
+                spellings.push_back(candidate.topic);
+            }
+        }
+    }
+    return spellings;
+}
+
+bool TopicIndex::confidenceOf(const std::string& topic, const std::string& response, float& out) const {
+    auto it = index.find(normalize(topic));
+    if (it == index.end()) return false;
+
+    for (const auto& candidate : it->second) {
+        if (candidate.response == response) {
+            out = candidate.confidence;
+            return true;
+        }
+    }
+    return false;
+}
+
+TopicIndex::Stats TopicIndex::stats() const {
+    Stats s;
+    s.hits = hits.load(std::memory_order_relaxed);
+    s.misses = misses.load(std::memory_order_relaxed);
+    s.topics = index.size();
+    s.candidates = candidateCount;
+    return s;
+}
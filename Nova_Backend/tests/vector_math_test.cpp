@@ -0,0 +1,106 @@
+// Checks every VectorMath implementation the CPU supports against the scalar
+// one on random vectors of many lengths. Below the scalar cutoff every ISA
+// must give the scalar result bit for bit; above it, reductions may round
+// differently. Built with the library and run by ctest.
+#include "../include/Core/VectorMath.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+    const VectorMath::Isa kIsas[] = { VectorMath::Isa::Scalar, VectorMath::Isa::SSE4, VectorMath::Isa::AVX2 };
+
+    struct Inputs {
+        std::vector<float> a, b;
+        float alpha;
+    };
+
+    struct Outputs {
+        float dot, norm, cosine, mse;
+        std::vector<float> axpy, mul;
+    };
+
+    Outputs runAll(const Inputs& in) {
+        size_t n = in.a.size();
+        Outputs out;
+        out.dot = VectorMath::dot(in.a.data(), in.b.data(), n);
+        out.norm = VectorMath::norm(in.a.data(), n);
+        out.cosine = VectorMath::cosine(in.a.data(), in.b.data(), n);
+        out.mse = VectorMath::mse(in.a.data(), in.b.data(), n);
+        out.axpy = in.b;
+        VectorMath::axpy(in.alpha, in.a.data(), out.axpy.data(), n);
+        out.mul.resize(n);
+        VectorMath::mul(in.a.data(), in.b.data(), out.mul.data(), n);
+        return out;
+    }
+
+    // Reductions are summed in a different order per ISA, so allow rounding
+    // error proportional to the magnitude of the terms
+    bool close(float got, float want, float scale) {
+        return std::fabs(got - want) <= 1e-5f * std::max(1.0f, scale);
+    }
+
+    bool same(float got, float want) {
+        return std::memcmp(&got, &want, sizeof(float)) == 0;
+    }
+
+    bool identical(const Outputs& got, const Outputs& want) {
+        return same(got.dot, want.dot) && same(got.norm, want.norm) && same(got.cosine, want.cosine) &&
+               same(got.mse, want.mse) && got.axpy == want.axpy && got.mul == want.mul;
+    }
+
+    int checkAgreement(std::mt19937& rng) {
+        std::normal_distribution<float> dist(0.0f, 1.0f);
+        int failures = 0;
+        for (size_t n = 0; n <= 67; ++n) {
+            Inputs in{ std::vector<float>(n), std::vector<float>(n), dist(rng) };
+            for (size_t i = 0; i < n; ++i) {
+                in.a[i] = dist(rng);
+                in.b[i] = dist(rng);
+            }
+            VectorMath::setIsa(VectorMath::Isa::Scalar);
+            Outputs want = runAll(in);
+            float scale = want.norm * VectorMath::norm(in.b.data(), n);
+
+            for (VectorMath::Isa isa : kIsas) {
+                if (isa == VectorMath::Isa::Scalar || !VectorMath::setIsa(isa)) continue;
+                Outputs got = runAll(in);
+                bool ok = close(got.dot, want.dot, scale) && close(got.norm, want.norm, want.norm) &&
+                          close(got.cosine, want.cosine, 1.0f) && close(got.mse, want.mse, want.mse);
+                for (size_t i = 0; ok && i < n; ++i)
+                    ok = close(got.axpy[i], want.axpy[i], std::fabs(want.axpy[i])) && close(got.mul[i], want.mul[i], std::fabs(want.mul[i]));
+                if (n < 8 && !identical(got, want)) ok = false;
+                if (!ok) {
+                    std::cerr << VectorMath::name(isa) << " disagrees with scalar at n=" << n << "\n";
+                    ++failures;
+                }
+            }
+        }
+
+        // Zero vectors must not divide by zero, on either side of the cutoff
+        for (size_t n : { 3, 8 }) {
+            std::vector<float> zero(n, 0.0f), one(n, 1.0f);
+            for (VectorMath::Isa isa : kIsas) {
+                if (!VectorMath::setIsa(isa)) continue;
+                if (VectorMath::cosine(zero.data(), one.data(), n) != 0.0f) {
+                    std::cerr << VectorMath::name(isa) << " cosine of a zero vector is not 0 at n=" << n << "\n";
+                    ++failures;
+                }
+            }
+        }
+        return failures;
+    }
+}
+
+int main() {
+    std::mt19937 rng(7);
+    VectorMath::Isa detected = VectorMath::isa();
+    int failures = checkAgreement(rng);
+    VectorMath::setIsa(detected);
+    std::cout << "VectorMath (" << VectorMath::name(detected) << ") agreement with scalar: "
+              << (failures == 0 ? "ok" : "FAILED") << "\n";
+    return failures == 0 ? 0 : 1;
+}
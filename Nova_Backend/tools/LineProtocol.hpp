@@ -0,0 +1,235 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Wire format shared by nova_server and nova_loadgen: one flat JSON object per
+// line, "\n" terminated, in both directions.
+//
+//   {"id":7,"op":"respond","input":"hello"}
+//   {"id":7,"ok":true,"response":"Hi there!"}
+//
+// Ops: respond (input), feedback (input, response, positive), teach
+// ("topic=response" input), confidence (input, response) and stats. Each
+// connection is its own ChatBotController session. Replies echo the request
+// id and can arrive out of order when the server runs several workers.
+namespace LineProtocol {
+
+    // Parsed request: string values unescaped, numbers and literals as written
+    using Object = std::unordered_map<std::string, std::string>;
+
+    namespace detail {
+        inline void skipSpace(std::string_view text, size_t& pos) {
+            while (pos < text.size() && (text[pos] == ' ' || text[pos] == '\t' || text[pos] == '\r')) ++pos;
+        }
+
+        inline void appendUtf8(std::string& out, uint32_t code) {
+            if (code < 0x80) {
+                out += static_cast<char>(code);
+            } else if (code < 0x800) {
+                out += static_cast<char>(0xC0 | (code >> 6));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else if (code < 0x10000) {
+                out += static_cast<char>(0xE0 | (code >> 12));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            } else {
+                out += static_cast<char>(0xF0 | (code >> 18));
+                out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (code & 0x3F));
+            }
+        }
+
+        inline bool readHex4(std::string_view text, size_t& pos, uint32_t& code) {
+            if (pos + 4 > text.size()) return false;
+            code = 0;
+            for (int i = 0; i < 4; ++i) {
+                char c = text[pos++];
+                code <<= 4;
+                if (c >= '0' && c <= '9') code |= c - '0';
+                else if (c >= 'a' && c <= 'f') code |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') code |= c - 'A' + 10;
+                else return false;
+            }
+            return true;
+        }
+
+        // pos is on the opening quote; leaves it past the closing one
+        inline bool readString(std::string_view text, size_t& pos, std::string& out) {
+            out.clear();
+            ++pos;
+            while (pos < text.size()) {
+                char c = text[pos++];
+                if (c == '"') return true;
+                if (c != '\\') {
+                    out += c;
+                    continue;
+                }
+                if (pos >= text.size()) return false;
+                switch (char e = text[pos++]) {
+                    case '"': case '\\': case '/': out += e; break;
+                    case 'b': out += '\b'; break;
+                    case 'f': out += '\f'; break;
+                    case 'n': out += '\n'; break;
+                    case 'r': out += '\r'; break;
+                    case 't': out += '\t'; break;
+                    case 'u': {
+                        uint32_t code;
+                        if (!readHex4(text, pos, code)) return false;
+                        if (code >= 0xD800 && code < 0xDC00) {  // High surrogate; expect the low half
+                            uint32_t low;
+                            if (pos + 2 > text.size() || text[pos] != '\\' || text[pos + 1] != 'u') return false;
+                            pos += 2;
+                            if (!readHex4(text, pos, low) || low < 0xDC00 || low >= 0xE000) return false;
+                            code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+                        }
+                        appendUtf8(out, code);
+                        break;
+                    }
+                    default: return false;
+                }
+            }
+            return false;
+        }
+    }
+
+    // Flat objects only: nested objects and arrays are rejected
+    inline bool parse(std::string_view line, Object& out) {
+        out.clear();
+        size_t pos = 0;
+        detail::skipSpace(line, pos);
+        if (pos >= line.size() || line[pos++] != '{') return false;
+        detail::skipSpace(line, pos);
+        if (pos < line.size() && line[pos] == '}') return true;
+
+        std::string key, value;
+        while (pos < line.size()) {
+            detail::skipSpace(line, pos);
+            if (pos >= line.size() || line[pos] != '"' || !detail::readString(line, pos, key)) return false;
+            detail::skipSpace(line, pos);
+            if (pos >= line.size() || line[pos++] != ':') return false;
+            detail::skipSpace(line, pos);
+            if (pos >= line.size()) return false;
+
+            if (line[pos] == '"') {
+                if (!detail::readString(line, pos, value)) return false;
+            } else {
+                size_t start = pos;
+                while (pos < line.size() && line[pos] != ',' && line[pos] != '}' && line[pos] != ' ') ++pos;
+                value.assign(line.substr(start, pos - start));
+                if (value.empty() || value[0] == '{' || value[0] == '[') return false;
+            }
+            out[key] = value;
+
+            detail::skipSpace(line, pos);
+            if (pos >= line.size()) return false;
+            if (line[pos] == '}') return true;
+            if (line[pos++] != ',') return false;
+        }
+        return false;
+    }
+
+    inline void appendQuoted(std::string& out, std::string_view text) {
+        out += '"';
+        for (char c : text) {
+            switch (c) {
+                case '"': out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\r': out += "\\r"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        char escaped[8];
+                        std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+                        out += escaped;
+                    } else {
+                        out += c;  // UTF-8 passes through
+                    }
+            }
+        }
+        out += '"';
+    }
+
+    // Builds one reply or request line: Writer().field(...).field(...).line()
+    class Writer {
+    public:
+        Writer& field(std::string_view key, std::string_view value) {
+            next(key);
+            appendQuoted(text, value);
+            return *this;
+        }
+        Writer& field(std::string_view key, const char* value) { return field(key, std::string_view(value)); }
+        Writer& field(std::string_view key, const std::string& value) { return field(key, std::string_view(value)); }
+        Writer& field(std::string_view key, bool value) { return raw(key, value ? "true" : "false"); }
+        Writer& field(std::string_view key, uint64_t value) { return raw(key, std::to_string(value)); }
+        Writer& field(std::string_view key, double value) {
+            char number[32];
+            std::snprintf(number, sizeof(number), "%.6g", std::isfinite(value) ? value : 0.0);
+            return raw(key, number);
+        }
+        Writer& raw(std::string_view key, std::string_view json) {  // Pre-encoded value, e.g. a nested object
+            next(key);
+            text += json;
+            return *this;
+        }
+        std::string object() const { return text + "}"; }
+        std::string line() const { return text + "}\n"; }
+
+    private:
+        std::string text = "{";
+        void next(std::string_view key) {
+            if (text.size() > 1) text += ',';
+            appendQuoted(text, key);
+            text += ':';
+        }
+    };
+
+    // Lock-free latency histogram with quarter-octave buckets from 1 us to ~16 s.
+    // Percentiles report the upper edge of the bucket, so they are within 19%.
+    class LatencyHistogram {
+    public:
+        static const int kBuckets = 4 * 24;
+
+        void record(double micros) {
+            double clamped = std::max(micros, 0.0);
+            int bucket = std::min(kBuckets - 1, static_cast<int>(4.0 * std::log2(clamped + 1.0)));
+            counts[bucket].fetch_add(1, std::memory_order_relaxed);
+            total.fetch_add(1, std::memory_order_relaxed);
+            uint64_t asInt = static_cast<uint64_t>(clamped);
+            uint64_t seen = maxMicros.load(std::memory_order_relaxed);
+            while (asInt > seen && !maxMicros.compare_exchange_weak(seen, asInt, std::memory_order_relaxed)) {}
+        }
+
+        uint64_t count() const { return total.load(std::memory_order_relaxed); }
+        uint64_t max() const { return maxMicros.load(std::memory_order_relaxed); }
+
+        double percentile(double p) const {  // p in 0..1; microseconds
+            uint64_t n = count();
+            if (n == 0) return 0.0;
+            uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * n)));
+            uint64_t seen = 0;
+            for (int b = 0; b < kBuckets; ++b) {
+                seen += counts[b].load(std::memory_order_relaxed);
+                if (seen >= rank) return std::min(std::exp2((b + 1) / 4.0) - 1.0, static_cast<double>(max()));
+            }
+            return static_cast<double>(max());
+        }
+
+        std::string json() const {
+            return Writer().field("count", count()).field("p50_us", percentile(0.5)).field("p90_us", percentile(0.9))
+                .field("p99_us", percentile(0.99)).field("max_us", max()).object();
+        }
+
+    private:
+        std::atomic<uint64_t> counts[kBuckets] = {};
+        std::atomic<uint64_t> total{0};
+        std::atomic<uint64_t> maxMicros{0};
+    };
+}
@@ -0,0 +1,67 @@
+// Inspects and converts binary model files (see ModelFile.hpp).
+//
+// Usage:
+//   nova_model_tool info <model.bin>
+//   nova_model_tool export <model.bin> <model.txt>   binary -> debug text
+//   nova_model_tool import <model.txt> <model.bin>   debug text -> binary
+//   nova_model_tool save <chatbot.db> <model.bin>    snapshot a database
+#include "../include/Core/ModelFile.hpp"
+#include "../include/Core/NeuralNet.hpp"
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace {
+    int usage() {
+        std::cerr << "Usage: nova_model_tool info <model.bin>\n"
+                  << "       nova_model_tool export <model.bin> <model.txt>\n"
+                  << "       nova_model_tool import <model.txt> <model.bin>\n"
+                  << "       nova_model_tool save <chatbot.db> <model.bin>\n";
+        return 2;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3) return usage();
+    std::string command = argv[1];
+
+    if (command == "info" && argc == 3) {
+        ModelFile model;
+        if (!model.open(argv[2])) {
+            std::cerr << "Cannot open " << argv[2] << std::endl;
+            return 1;
+        }
+        std::cout << argv[2] << ": version " << ModelFile::kVersion << ", dimension " << model.dimension() << ", "
+                  << model.size(ModelFile::Words) << " words, " << model.size(ModelFile::Responses) << " responses" << std::endl;
+        return 0;
+    }
+
+    if (command == "export" && argc == 4) {
+        ModelFile model;
+        std::ofstream out(argv[3]);
+        if (!model.open(argv[2]) || !out || !ModelFile::exportText(model, out)) {
+            std::cerr << "Export from " << argv[2] << " to " << argv[3] << " failed" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "import" && argc == 4) {
+        std::ifstream in(argv[2]);
+        ModelFile::Data data;
+        if (!in || !ModelFile::importText(in, data) || !ModelFile::save(argv[3], data)) {
+            std::cerr << "Import from " << argv[2] << " to " << argv[3] << " failed" << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+    if (command == "save" && argc == 4) {
+        DatabaseConfig config;
+        config.path = argv[2];
+        NeuralNet net(std::make_shared<DatabasePool>(config));
+        return net.saveModelToFile(argv[3]) ? 0 : 1;
+    }
+
+    return usage();
+}
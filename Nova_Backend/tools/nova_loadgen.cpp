@@ -0,0 +1,202 @@
+// Load generator for nova_server: opens N connections, each on its own thread,
+// keeps `depth` requests in flight per connection and reports throughput and
+// client-side latency percentiles, followed by the server's own histograms.
+//
+// Requests are "respond" ops by default; --feedback P turns P% of them into
+// feedback, which changes confidences in the server's database.
+//
+// Usage: nova_loadgen [--port 7878] [--connections 8] [--requests 1000] [--depth 1]
+//                     [--inputs file] [--feedback 0]
+#include "LineProtocol.hpp"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    struct Options {
+        uint16_t port = 7878;
+        size_t connections = 8;
+        size_t requests = 1000;  // Per connection
+        size_t depth = 1;
+        int feedbackPercent = 0;
+        std::vector<std::string> inputs = {"hello", "how are you", "what is your name", "tell me a joke",
+                                           "good morning", "thank you", "qzxv unseen words"};
+    };
+
+    int connectTo(uint16_t port) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            close(fd);
+            return -1;
+        }
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        return fd;
+    }
+
+    bool sendAll(int fd, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) return false;
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Buffered line reader over a blocking socket
+    struct LineReader {
+        explicit LineReader(int fd) : fd(fd) {}
+
+        int fd;
+        std::string buffer;
+        size_t start = 0;
+
+        bool next(std::string& line) {
+            while (true) {
+                size_t end = buffer.find('\n', start);
+                if (end != std::string::npos) {
+                    line.assign(buffer, start, end - start);
+                    start = end + 1;
+                    return true;
+                }
+                buffer.erase(0, start);
+                start = 0;
+                char chunk[16 * 1024];
+                ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                buffer.append(chunk, static_cast<size_t>(n));
+            }
+        }
+    };
+
+    std::string request(uint64_t id, const Options& options, size_t n) {
+        const std::string& input = options.inputs[n % options.inputs.size()];
+        LineProtocol::Writer writer;
+        writer.field("id", id);
+        if (options.feedbackPercent > 0 && static_cast<int>(n % 100) < options.feedbackPercent) {
+            writer.field("op", "feedback").field("input", input).field("response", input).field("positive", n % 2 == 0);
+        } else {
+            writer.field("op", "respond").field("input", input);
+        }
+        return writer.line();
+    }
+
+    void runConnection(const Options& options, size_t index, LineProtocol::LatencyHistogram& latency,
+                       std::atomic<uint64_t>& errors) {
+        int fd = connectTo(options.port);
+        if (fd < 0) {
+            errors += options.requests;
+            return;
+        }
+
+        LineReader reader(fd);
+        std::unordered_map<uint64_t, Clock::time_point> inFlight;
+        uint64_t nextId = 1;
+        size_t sent = 0, received = 0;
+        std::string line;
+        LineProtocol::Object reply;
+        while (received < options.requests) {
+            // Top up to `depth` outstanding requests, then wait for one reply
+            std::string batch;
+            while (sent < options.requests && inFlight.size() < options.depth) {
+                inFlight[nextId] = Clock::now();
+                batch += request(nextId++, options, index * 7919 + sent++);
+            }
+            if (!batch.empty() && !sendAll(fd, batch)) break;
+            if (!reader.next(line)) break;
+
+            received++;
+            if (!LineProtocol::parse(line, reply) || reply["ok"] != "true") errors++;
+            auto it = inFlight.find(std::strtoull(reply["id"].c_str(), nullptr, 10));
+            if (it == inFlight.end()) continue;
+            latency.record(std::chrono::duration<double, std::micro>(Clock::now() - it->second).count());
+            inFlight.erase(it);
+        }
+        errors += options.requests - received;
+        close(fd);
+    }
+
+    int usage() {
+        std::cerr << "Usage: nova_loadgen [--port 7878] [--connections 8] [--requests 1000] [--depth 1]\n"
+                  << "                    [--inputs file] [--feedback 0]\n";
+        return 2;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        const char* value = argv[i + 1];
+        if (flag == "--port") options.port = static_cast<uint16_t>(std::atoi(value));
+        else if (flag == "--connections") options.connections = std::strtoul(value, nullptr, 10);
+        else if (flag == "--requests") options.requests = std::strtoul(value, nullptr, 10);
+        else if (flag == "--depth") options.depth = std::max<size_t>(1, std::strtoul(value, nullptr, 10));
+        else if (flag == "--feedback") options.feedbackPercent = std::atoi(value);
+        else if (flag == "--inputs") {
+            std::ifstream file(value);
+            std::vector<std::string> inputs;
+            for (std::string line; std::getline(file, line);) {
+                if (!line.empty()) inputs.push_back(line);
+            }
+            if (inputs.empty()) {
+                std::cerr << "No inputs in " << value << std::endl;
+                return 1;
+            }
+            options.inputs = std::move(inputs);
+        } else {
+            return usage();
+        }
+    }
+    if (argc % 2 == 0) return usage();
+
+    LineProtocol::LatencyHistogram latency;
+    std::atomic<uint64_t> errors{0};
+    auto start = Clock::now();
+    std::vector<std::thread> clients;
+    for (size_t c = 0; c < options.connections; ++c) {
+        clients.emplace_back(runConnection, std::cref(options), c, std::ref(latency), std::ref(errors));
+    }
+    for (auto& client : clients) client.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::cout << options.connections << " connections x " << options.requests << " requests, depth " << options.depth
+              << ": " << latency.count() / seconds << " requests/s, p50 " << latency.percentile(0.5) << " us, p90 "
+              << latency.percentile(0.9) << " us, p99 " << latency.percentile(0.99) << " us, max " << latency.max()
+              << " us, " << errors.load() << " errors" << std::endl;
+
+    // The server's view, per op
+    int fd = connectTo(options.port);
+    if (fd >= 0) {
+        LineReader reader(fd);
+        std::string line;
+        if (sendAll(fd, LineProtocol::Writer().field("id", uint64_t(1)).field("op", "stats").line()) && reader.next(line)) {
+            std::cout << "server: " << line << std::endl;
+        }
+        close(fd);
+    }
+    return errors.load() == 0 ? 0 : 1;
+}
@@ -0,0 +1,313 @@
+// Serves ChatBotController over localhost: line-delimited JSON (see
+// LineProtocol.hpp) on a TCP socket. One poll() loop owns every socket and
+// hands parsed requests to a ThreadPool; workers post finished replies back
+// through a self-pipe. Each connection gets its own session. Per-op latency
+// histograms are returned by the "stats" op and printed on shutdown.
+//
+// Usage: nova_server [--port 7878] [--threads N] [--db chatbot.db] [--model trained_model.bin]
+#include "../include/Controller.hpp"
+#include "../include/Core/ThreadPool.hpp"
+#include "LineProtocol.hpp"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+    const size_t kMaxLine = 64 * 1024;  // Longer requests close the connection
+    const char* const kOps[] = {"respond", "feedback", "teach", "confidence", "stats"};
+    const size_t kOpCount = sizeof(kOps) / sizeof(kOps[0]);
+
+    int wakeFds[2] = {-1, -1};  // Self-pipe: workers and the signal handler wake poll()
+    volatile std::sig_atomic_t stopRequested = 0;
+
+    void onSignal(int) {
+        stopRequested = 1;
+        char byte = 0;
+        (void)!write(wakeFds[1], &byte, 1);
+    }
+
+    bool setNonBlocking(int fd) {
+        int flags = fcntl(fd, F_GETFL, 0);
+        return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    struct Connection {
+        int fd = -1;
+        std::string in;
+        std::string out;
+        ChatBotController::SessionId session = ChatBotController::kDefaultSession;
+    };
+
+    class Server {
+    public:
+        Server(ChatBotController& controller, size_t threads) : controller(controller), workers(threads) {}
+
+        bool listenOn(uint16_t port) {
+            listenFd = socket(AF_INET, SOCK_STREAM, 0);
+            if (listenFd < 0) {
+                std::cerr << "[Server] socket: " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            int yes = 1;
+            setsockopt(listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = htons(port);
+            address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);  // Local clients only
+            if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+                listen(listenFd, SOMAXCONN) != 0 || !setNonBlocking(listenFd)) {
+                std::cerr << "[Server] Cannot listen on 127.0.0.1:" << port << ": " << std::strerror(errno) << std::endl;
+                return false;
+            }
+            std::cerr << "[Server] Listening on 127.0.0.1:" << port << " with " << workers.size() << " workers" << std::endl;
+            return true;
+        }
+
+        void run() {
+            std::vector<pollfd> fds;
+            std::vector<uint64_t> ids;  // Connection id per fds entry (after the first two)
+            while (!stopRequested) {
+                fds.clear();
+                ids.clear();
+                fds.push_back({wakeFds[0], POLLIN, 0});
+                fds.push_back({listenFd, POLLIN, 0});
+                for (const auto& [id, connection] : connections) {
+                    fds.push_back({connection.fd, static_cast<short>(POLLIN | (connection.out.empty() ? 0 : POLLOUT)), 0});
+                    ids.push_back(id);
+                }
+
+                if (poll(fds.data(), fds.size(), -1) < 0) {
+                    if (errno == EINTR) continue;
+                    std::cerr << "[Server] poll: " << std::strerror(errno) << std::endl;
+                    break;
+                }
+
+                if (fds[0].revents & POLLIN) drainWakeups();
+                if (fds[1].revents & POLLIN) acceptAll();
+                for (size_t i = 2; i < fds.size(); ++i) {
+                    if (!fds[i].revents) continue;
+                    auto it = connections.find(ids[i - 2]);
+                    if (it == connections.end()) continue;
+                    bool open = true;
+                    if (fds[i].revents & (POLLIN | POLLHUP | POLLERR)) open = readFrom(it->first, it->second);
+                    if (open && !it->second.out.empty()) open = writeTo(it->second);
+                    if (!open) closeConnection(it);
+                }
+            }
+
+            while (!connections.empty()) closeConnection(connections.begin());
+            close(listenFd);
+        }
+
+        void printStats(std::ostream& out) const {
+            out << "[Server] Latency per op (server side, parse to reply queued):" << std::endl;
+            for (size_t op = 0; op < kOpCount; ++op) {
+                if (histograms[op].count() == 0) continue;
+                out << "  " << kOps[op] << ": " << histograms[op].count() << " requests, p50 " << histograms[op].percentile(0.5)
+                    << " us, p90 " << histograms[op].percentile(0.9) << " us, p99 " << histograms[op].percentile(0.99)
+                    << " us, max " << histograms[op].max() << " us" << std::endl;
+            }
+        }
+
+    private:
+        ChatBotController& controller;
+        int listenFd = -1;
+        std::map<uint64_t, Connection> connections;  // Loop thread only
+        uint64_t nextConnection = 1;
+        LineProtocol::LatencyHistogram histograms[kOpCount];
+
+        std::mutex doneMutex;
+        std::vector<std::pair<uint64_t, std::string>> done;  // Finished replies, by connection id
+
+        ThreadPool workers;  // Last: its destructor runs queued requests, which use the members above
+
+        void acceptAll() {
+            while (true) {
+                int fd = accept(listenFd, nullptr, nullptr);
+                if (fd < 0) return;  // EAGAIN: no more pending connections
+                int yes = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+                setNonBlocking(fd);
+                Connection& connection = connections[nextConnection++];
+                connection.fd = fd;
+                connection.session = controller.openSession();
+            }
+        }
+
+        void closeConnection(std::map<uint64_t, Connection>::iterator it) {
+            close(it->second.fd);
+            controller.closeSession(it->second.session);  // Turns still running keep the session alive
+            connections.erase(it);
+        }
+
+        bool readFrom(uint64_t id, Connection& connection) {
+            char buffer[16 * 1024];
+            while (true) {
+                ssize_t n = recv(connection.fd, buffer, sizeof(buffer), 0);
+                if (n == 0) return false;
+                if (n < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                connection.in.append(buffer, static_cast<size_t>(n));
+            }
+
+            size_t start = 0;
+            for (size_t end; (end = connection.in.find('\n', start)) != std::string::npos; start = end + 1) {
+                dispatch(id, connection, std::string_view(connection.in).substr(start, end - start));
+            }
+            connection.in.erase(0, start);
+            return connection.in.size() <= kMaxLine;
+        }
+
+        bool writeTo(Connection& connection) {
+            while (!connection.out.empty()) {
+                ssize_t n = send(connection.fd, connection.out.data(), connection.out.size(), MSG_NOSIGNAL);
+                if (n < 0) {
+                    if (errno == EAGAIN || errno == EWOULDBLOCK) return true;
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                connection.out.erase(0, static_cast<size_t>(n));
+            }
+            return true;
+        }
+
+        static std::string error(uint64_t id, const char* message) {
+            return LineProtocol::Writer().field("id", id).field("ok", false).field("error", message).line();
+        }
+
+        void dispatch(uint64_t connectionId, Connection& connection, std::string_view line) {
+            if (line.empty() || line == "\r") return;
+            auto started = std::chrono::steady_clock::now();
+
+            LineProtocol::Object request;
+            if (!LineProtocol::parse(line, request)) {
+                connection.out += error(0, "malformed JSON");
+                return;
+            }
+            uint64_t id = std::strtoull(request["id"].c_str(), nullptr, 10);
+            const std::string& opName = request["op"];
+            size_t op = 0;
+            while (op < kOpCount && opName != kOps[op]) ++op;
+            if (op == kOpCount) {
+                connection.out += error(id, "unknown op");
+                return;
+            }
+
+            if (opName == "stats") {  // Cheap; answered on the loop thread
+                LineProtocol::Writer stats;
+                for (size_t i = 0; i < kOpCount; ++i) stats.raw(kOps[i], histograms[i].json());
+                ResponseCache::Stats cache = controller.getResponseCacheStats();
+                stats.raw("cache", LineProtocol::Writer().field("hit_rate", cache.hitRate()).field("hits", cache.hits)
+                    .field("misses", cache.misses).field("nn_hits", cache.generatedHits).field("evictions", cache.evictions)
+                    .field("invalidations", cache.invalidations).field("entries", static_cast<uint64_t>(cache.entries))
+                    .field("bytes", static_cast<uint64_t>(cache.bytes)).object());
+                connection.out += LineProtocol::Writer().field("id", id).field("ok", true).raw("stats", stats.object()).line();
+                histograms[op].record(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count());
+                return;
+            }
+
+            auto session = connection.session;
+            workers.submit([this, connectionId, session, id, op, request = std::move(request), started]() mutable {
+                std::string reply = handle(session, id, op, request);
+                histograms[op].record(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - started).count());
+                {
+                    std::lock_guard<std::mutex> lock(doneMutex);
+                    done.emplace_back(connectionId, std::move(reply));
+                }
+                char byte = 1;
+                (void)!write(wakeFds[1], &byte, 1);
+            });
+        }
+
+        // Worker thread
+        std::string handle(ChatBotController::SessionId session, uint64_t id, size_t op, LineProtocol::Object& request) {
+            const std::string& input = request["input"];
+            LineProtocol::Writer reply;
+            reply.field("id", id).field("ok", true);
+            switch (op) {
+                case 0:
+                    reply.field("response", controller.getChatbotResponse(session, input));
+                    break;
+                case 1:
+                    controller.provideFeedback(input, request["response"], request["positive"] == "true");
+                    break;
+                case 2:
+                    if (input.find('=') == std::string::npos) return error(id, "teach input must be topic=response");
+                    controller.teachMode(input);
+                    break;
+                case 3:
+                    reply.field("confidence", controller.getConfidenceScore(input, request["response"]));
+                    break;
+            }
+            return reply.line();
+        }
+
+        void drainWakeups() {
+            char bytes[256];
+            while (read(wakeFds[0], bytes, sizeof(bytes)) > 0) {}
+
+            std::vector<std::pair<uint64_t, std::string>> replies;
+            {
+                std::lock_guard<std::mutex> lock(doneMutex);
+                replies.swap(done);
+            }
+            for (auto& [connectionId, reply] : replies) {
+                auto it = connections.find(connectionId);
+                if (it != connections.end()) it->second.out += reply;  // Dropped if the client has gone
+            }
+        }
+    };
+}
+
+int main(int argc, char* argv[]) {
+    uint16_t port = 7878;
+    size_t threads = 0;
+    std::string modelFile = "trained_model.bin";
+    DatabaseConfig config;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string flag = argv[i];
+        if (flag == "--port") port = static_cast<uint16_t>(std::atoi(argv[i + 1]));
+        else if (flag == "--threads") threads = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (flag == "--db") config.path = argv[i + 1];
+        else if (flag == "--model") modelFile = argv[i + 1];
+        else {
+            std::cerr << "Usage: nova_server [--port 7878] [--threads N] [--db chatbot.db] [--model trained_model.bin]" << std::endl;
+            return 2;
+        }
+    }
+
+    if (pipe(wakeFds) != 0 || !setNonBlocking(wakeFds[0]) || !setNonBlocking(wakeFds[1])) {
+        std::cerr << "[Server] pipe: " << std::strerror(errno) << std::endl;
+        return 1;
+    }
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+
+    ChatBotController controller(std::make_shared<DatabasePool>(config));
+    controller.initialize(modelFile);  // Serves indexed replies while the rest warms up
+    {
+        Server server(controller, threads);
+        if (!server.listenOn(port)) return 1;
+        server.run();
+        server.printStats(std::cerr);
+    }  // Workers finish the requests already queued before the controller goes
+    return 0;
+}
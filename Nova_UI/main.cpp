@@ -1,17 +1,12 @@
 #include <QApplication>
 #include "MainWindow.h"
-#include "../Nova_Backend/include/Controller.hpp"
 
 int main(int argc, char *argv[])
 {
     QApplication app(argc, argv);
 
     try {
-        // Create and initialize the backend controller.
-        ChatBotController chatController;
-        chatController.initialize("trained_model.txt");
-
-        // Create the main window
+        // Create the main window; it owns and initializes the backend controller
         MainWindow m;
         m.show();
 
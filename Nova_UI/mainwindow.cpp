@@ -8,6 +8,7 @@
 #include <QApplication>
 #include <QProgressBar>
 #include <QEvent>
+#include <QStatusBar>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -28,7 +29,11 @@ MainWindow::MainWindow(QWidget *parent)
     setupDatabaseViewerPage();
 
     m_chatController = new ChatBotController();
-    m_chatController->initialize("trained_model.txt");
+    connect(this, &MainWindow::replyReady, this, &MainWindow::handleReply, Qt::QueuedConnection);
+    // Exact matches are answered at once; the status bar follows the rest of the startup
+    m_chatController->initialize("trained_model.bin", [this](const ChatBotController::StartupStatus& status) {
+        QMetaObject::invokeMethod(this, [this, status]() { showStartupStatus(status); }, Qt::QueuedConnection);
+    });
 
     // Apply styling if needed
     applyStyling();
@@ -44,7 +49,21 @@ void MainWindow::showLoginPage()
     stackedWidget->setCurrentWidget(loginPage);
 }
 
-MainWindow::~MainWindow() {}
+MainWindow::~MainWindow()
+{
+    delete m_chatController;  // Joins the startup thread before this window goes away
+}
+
+void MainWindow::showStartupStatus(const ChatBotController::StartupStatus& status)
+{
+    if (status.stage == ChatBotController::StartupStage::Ready) {
+        statusBar()->showMessage(QString("Nova is ready (%1 ms)").arg(status.elapsedMs, 0, 'f', 0), 3000);
+        return;
+    }
+    statusBar()->showMessage(QString("Warming up: %1 (%2%)")
+                                 .arg(ChatBotController::stageName(status.stage))
+                                 .arg(static_cast<int>(status.progress * 100)));
+}
 
 void MainWindow::setupChatSelectionPage()
 {
@@ -485,38 +504,17 @@ void MainWindow::sendMessage()
             normalLastMsgLabel->setText("You: " + message);
         }
 
-        QTimer *replyTimer = new QTimer(this);
-        replyTimer->setSingleShot(true);
-        connect(replyTimer, &QTimer::timeout, [this, message, replyTimer]() {
-            if (!m_chatController) {
-                qWarning() << "[ERROR] Chat controller is null!";
-                return;
-            }
-            std::string inputStd = message.toStdString();
-            std::string responseStd = m_chatController->getChatbotResponse(inputStd);
-            QString responseText = QString::fromStdString(responseStd);
-            responseText.replace("<HUMAN>", userName, Qt::CaseInsensitive);
-            responseText.replace("Human", userName, Qt::CaseInsensitive);
-            responseText.replace("human", userName, Qt::CaseInsensitive);
-
-            addBotMessage(responseText, message);
-
-            QTimer *scrollTimer = new QTimer(this);
-            scrollTimer->setSingleShot(true);
-            connect(scrollTimer, &QTimer::timeout, [this, scrollTimer]() {
-                scrollArea->verticalScrollBar()->setValue(
-                    scrollArea->verticalScrollBar()->maximum()
-                    );
-                scrollTimer->deleteLater();
-            });
-            scrollTimer->start(50);
+        if (!m_chatController) {
+            qWarning() << "[ERROR] Chat controller is null!";
+            return;
+        }
 
-            if (normalLastMsgLabel) {
-                normalLastMsgLabel->setText("Nova: " + responseText);
-            }
-            replyTimer->deleteLater();
-        });
-        replyTimer->start(500);
+        // Answered on the controller's worker thread; a newer message supersedes one still waiting
+        pendingReplyId = m_chatController->submitRequest(message.toStdString(), [this](const ChatBotController::Reply &reply) {
+            if (reply.cancelled) return;
+            emit replyReady(reply.id, QString::fromStdString(reply.input), QString::fromStdString(reply.response),
+                            reply.latencyMs, reply.queuedMs);
+        }, true);
     } else {
     // --- TEACHING MODE (SIMPLIFIED) ---
     addTeachingMessage(message, true); // User message
@@ -539,7 +537,7 @@ void MainWindow::sendMessage()
             std::string teachingInput = currentTeachingInput.toStdString() + "=" +
                                         currentTeachingResponse.toStdString();
 
-            m_chatController->teachMode(teachingInput);
+            m_chatController->submitTeach(teachingInput);
 
             addTeachingMessage("Got it! I'll respond with \"" + currentTeachingResponse +
                                    "\" when asked \"" + currentTeachingInput + "\"", false);
@@ -559,6 +557,39 @@ void MainWindow::sendMessage()
     }
 }
 
+void MainWindow::handleReply(quint64 id, const QString &input, const QString &response, double latencyMs, double queuedMs)
+{
+    if (id != pendingReplyId) return;  // Superseded while the signal was queued
+
+    QString responseText = response;
+    responseText.replace("<HUMAN>", userName, Qt::CaseInsensitive);
+    responseText.replace("Human", userName, Qt::CaseInsensitive);
+    responseText.replace("human", userName, Qt::CaseInsensitive);
+
+    // Keep the short pause before Nova answers, counting the time the backend already took
+    int pauseMs = qMax(0, 500 - static_cast<int>(latencyMs));
+    QTimer::singleShot(pauseMs, this, [this, input, responseText, latencyMs, queuedMs]() {
+        addBotMessage(responseText, input);
+
+        QTimer *scrollTimer = new QTimer(this);
+        scrollTimer->setSingleShot(true);
+        connect(scrollTimer, &QTimer::timeout, [this, scrollTimer]() {
+            scrollArea->verticalScrollBar()->setValue(
+                scrollArea->verticalScrollBar()->maximum()
+                );
+            scrollTimer->deleteLater();
+        });
+        scrollTimer->start(50);
+
+        if (normalLastMsgLabel) {
+            normalLastMsgLabel->setText("Nova: " + responseText);
+        }
+        statusBar()->showMessage(QString("Replied in %1 ms (%2 ms queued)")
+                                     .arg(latencyMs, 0, 'f', 1)
+                                     .arg(queuedMs, 0, 'f', 1), 5000);
+    });
+}
+
 void MainWindow::fadeToWidget(QWidget* newWidget) {
     QWidget* current = stackedWidget->currentWidget();
     if (current == newWidget) return;
@@ -854,14 +885,14 @@ QWidget* MainWindow::createMessageWidget(const QString &message, bool isUser, co
 
             connect(thumbsUp, &QPushButton::clicked, [this, originalInput, message, confidenceBar, lockButtons]() {
                 if (m_chatController)
-                    m_chatController->provideFeedback(originalInput.toStdString(), message.toStdString(), true);
+                    m_chatController->submitFeedback(originalInput.toStdString(), message.toStdString(), true);
                 confidenceBar->show();
                 lockButtons();
             });
 
             connect(thumbsDown, &QPushButton::clicked, [this, originalInput, message, confidenceBar, lockButtons]() {
                 if (m_chatController)
-                    m_chatController->provideFeedback(originalInput.toStdString(), message.toStdString(), false);
+                    m_chatController->submitFeedback(originalInput.toStdString(), message.toStdString(), false);
                 confidenceBar->show();
                 lockButtons();
             });
@@ -872,12 +903,12 @@ QWidget* MainWindow::createMessageWidget(const QString &message, bool isUser, co
         if (!originalInput.isEmpty()) {
             connect(thumbsUp, &QPushButton::clicked, [this, originalInput, message]() {
                 if (m_chatController) {
-                    m_chatController->provideFeedback(originalInput.toStdString(), message.toStdString(), true);
+                    m_chatController->submitFeedback(originalInput.toStdString(), message.toStdString(), true);
                 }
             });
             connect(thumbsDown, &QPushButton::clicked, [this, originalInput, message]() {
                 if (m_chatController) {
-                    m_chatController->provideFeedback(originalInput.toStdString(), message.toStdString(), false);
+                    m_chatController->submitFeedback(originalInput.toStdString(), message.toStdString(), false);
                 }
             });
         }
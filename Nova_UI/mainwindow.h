@@ -36,7 +36,12 @@ public:
     void setUserName(const QString &name) { userName = name; }
     QString getUserName() const { return userName; }
 
+signals:
+    // Emitted on the controller's worker thread, delivered queued to handleReply
+    void replyReady(quint64 id, const QString &input, const QString &response, double latencyMs, double queuedMs);
+
 private slots:
+    void handleReply(quint64 id, const QString &input, const QString &response, double latencyMs, double queuedMs);
     void showLoginPage();
     void showChatSelection();
     void showNormalChat();
@@ -50,11 +55,13 @@ protected:
 
 private:
     ChatBotController* m_chatController;
+    quint64 pendingReplyId = 0;  // Latest request; replies to older ones are dropped
     QString userName;
     QLabel *userLabel;
     QStackedWidget *stackedWidget;
     void addUserMessage(const QString &message);
     void addBotMessage(const QString &message);
+    void showStartupStatus(const ChatBotController::StartupStatus &status);
     QVBoxLayout *chatLayout = nullptr;
 
     // Login Page